@@ -6,7 +6,49 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <bit>
+#include <cstdlib>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+// kernels of every instruction set are compiled, and selected at run time
+#define ISOLATION_FOREST_TARGET(isa) __attribute__((target(isa)))
+#define ISOLATION_FOREST_AVX2
+#define ISOLATION_FOREST_AVX512
+#else
+// kernels of the instruction sets enabled at compile time are compiled
+#define ISOLATION_FOREST_TARGET(isa)
+#if defined(__AVX2__) || defined(__AVX512F__)
+#define ISOLATION_FOREST_AVX2
+#endif
+#if defined(__AVX512F__)
+#define ISOLATION_FOREST_AVX512
+#endif
+#endif
+#if defined(ISOLATION_FOREST_AVX2) || defined(ISOLATION_FOREST_AVX512)
+#include <immintrin.h>
+#endif
 #include <iterator>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <shared_mutex>
+#include <unordered_map>
 #include <assert.h>
 
 /**
@@ -87,216 +129,4179 @@ namespace IsolationForest {
 			**/
 			{ forest.score(value, size) } -> std::same_as<typename FOREST::value_type>;
 		};
+
+		/**
+		* \brief concept of a streaming detector, which is updated point by point
+		**/
+		template<class DETECTOR>
+		concept IStreamDetector = std::is_floating_point_v<typename DETECTOR::value_type> &&
+			                      requires (DETECTOR detector, const DETECTOR& model, typename DETECTOR::value_type value) {
+
+			/**
+			* \brief insert a point
+			* @param {value_type, in} value
+			**/
+			detector.insert(value);
+
+			/**
+			* \brief calculate given value "outlier" score
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
+			**/
+			{ model.score(value) } -> std::same_as<typename DETECTOR::value_type>;
+		};
+
+		/**
+		* \brief concept of a streaming forest, which is updated point by point over a sliding window
+		**/
+		template<class FOREST>
+		concept IStreamForest = IStreamDetector<FOREST> &&
+			                    requires (FOREST forest, typename FOREST::value_type value, std::size_t id) {
+
+			/**
+			* \brief insert a point
+			* @param {value_type, in}  value
+			* @param {size_t,     out} point id
+			**/
+			{ forest.insert(value) } -> std::same_as<std::size_t>;
+
+			/**
+			* \brief remove a previously inserted point
+			* @param {size_t, in} point id
+			**/
+			{ forest.erase(id) } -> std::same_as<void>;
+		};
 	};
 
-	/**
-	* implementation of isolation forest interface
-	**/
-	namespace Implementation {
+	/**
+	* implementation of isolation forest interface
+	**/
+	namespace Implementation {
+
+		/**
+		* \brief Interface::INode implementation
+		**/
+		template<typename T, typename I = std::int64_t>
+			requires(std::is_floating_point_v<T>)
+		struct INode {
+			using size_type = I;
+			using value_type = T;
+
+			value_type split_value{};
+			size_type left{ -1 };
+			size_type right{ -1 };
+		};
+		static_assert(Interface::INode<INode<double>>);
+
+		/**
+		* \brief math functions which are also usable in constant evaluation.
+		*        at run time they forward to <cmath>, so run time results are unaffected.
+		**/
+		namespace Math {
+			/**
+			* \brief natural logarithm of a positive value (as std::log: -inf for zero, NaN for NaN and negative values, inf for inf)
+			* @param {floating_point, in}  value
+			* @param {floating_point, out} natural logarithm of value
+			**/
+			template<typename T>
+				requires(std::is_floating_point_v<T>)
+			constexpr T log(const T x) noexcept {
+				if (!std::is_constant_evaluated()) {
+					return std::log(x);
+				}
+
+				// special values, which the normalization below would never bring into [1, 2)
+				if (x != x) {
+					return x;
+				}
+				if (x == std::numeric_limits<T>::infinity()) {
+					return x;
+				}
+				if (x == T{}) {
+					return -std::numeric_limits<T>::infinity();
+				}
+				if (x < T{}) {
+					return std::numeric_limits<T>::quiet_NaN();
+				}
+
+				// x = m * 2^e, m in [1, 2)
+				T m{ x };
+				T e{};
+				while (m >= static_cast<T>(2.0)) {
+					m /= static_cast<T>(2.0);
+					++e;
+				}
+				while (m < static_cast<T>(1.0)) {
+					m *= static_cast<T>(2.0);
+					--e;
+				}
+
+				// log(m) = 2 * atanh((m - 1) / (m + 1))
+				const T z{ (m - static_cast<T>(1.0)) / (m + static_cast<T>(1.0)) };
+				const T z2{ z * z };
+				T term{ z };
+				T sum{};
+				for (std::size_t k{ 1 }; sum + term / static_cast<T>(k) != sum; k += 2) {
+					sum += term / static_cast<T>(k);
+					term *= z2;
+				}
+
+				return static_cast<T>(2.0) * sum + e * static_cast<T>(0.693147180559945309417232121458176568L);
+			}
+
+			/**
+			* \brief two raised to the power of given value
+			* @param {floating_point, in}  exponent
+			* @param {floating_point, out} 2^exponent
+			**/
+			template<typename T>
+				requires(std::is_floating_point_v<T>)
+			constexpr T exp2(const T x) noexcept {
+				if (!std::is_constant_evaluated()) {
+					return std::pow(static_cast<T>(2.0), x);
+				}
+
+				if (x != x) {
+					return x;
+				}
+				const T clamped{ std::clamp(x, static_cast<T>(std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits),
+					                           static_cast<T>(std::numeric_limits<T>::max_exponent)) };
+
+				// 2^x = 2^n * e^(f * ln(2)), n integral, f in [0, 1)
+				T n{ static_cast<T>(static_cast<std::int64_t>(clamped)) };
+				if (n > clamped) {
+					n -= static_cast<T>(1.0);
+				}
+				const T y{ (clamped - n) * static_cast<T>(0.693147180559945309417232121458176568L) };
+				T term{ static_cast<T>(1.0) };
+				T sum{};
+				for (std::size_t k{ 1 }; sum + term != sum; ++k) {
+					sum += term;
+					term *= y / static_cast<T>(k);
+				}
+
+				for (; n > T{}; n -= static_cast<T>(1.0)) {
+					sum *= static_cast<T>(2.0);
+				}
+				for (; n < T{}; n += static_cast<T>(1.0)) {
+					sum /= static_cast<T>(2.0);
+				}
+
+				return sum;
+			}
+		};
+
+		/**
+		* \brief splitmix64 random number generator.
+		*        streams can be forked, so every tree node owns an independent stream
+		*        and the tree does not depend on the order in which its nodes are built.
+		**/
+		struct Random {
+			std::uint64_t state{};
+
+			/**
+			* \brief advance the generator
+			* @param {uint64_t, out} random value
+			**/
+			constexpr std::uint64_t next() {
+				this->state += 0x9E3779B97F4A7C15ull;
+				return Random::mix(this->state);
+			}
+
+			/**
+			* \brief derive an independent stream from this generator
+			* @param {uint64_t, in}  stream id
+			* @param {Random,   out} generator of the derived stream
+			**/
+			constexpr Random fork(const std::uint64_t stream) const {
+				return Random{ Random::mix(this->state ^ Random::mix(stream + 0x9E3779B97F4A7C15ull)) };
+			}
+
+			/**
+			* \brief splitmix64 finalizer
+			**/
+			static constexpr std::uint64_t mix(std::uint64_t z) {
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				return z ^ (z >> 31);
+			}
+		};
+
+		/**
+		* \brief outcome of partitioning a range
+		**/
+		template<typename T>
+		struct Partition {
+			std::size_t mid{};                                    // amount of elements which are smaller than pivot
+			T left_min{ std::numeric_limits<T>::infinity() };      // extremes of elements which are smaller than pivot
+			T left_max{ -std::numeric_limits<T>::infinity() };
+			T right_min{ std::numeric_limits<T>::infinity() };     // extremes of elements which are not smaller than pivot
+			T right_max{ -std::numeric_limits<T>::infinity() };
+		};
+
+		/**
+		* \brief vectorized partition kernels.
+		*        each kernel processes whole vectors of a range: elements smaller than pivot are compressed
+		*        to the front of the range, other elements are compressed to scratch, and the extremes of both
+		*        sides are accumulated. kernels return the amount of elements they processed.
+		*        rank kernels count the leading thresholds of a cache line (see WideForest) which a value is not smaller than.
+		*        the kernel of the best instruction set supported by the cpu is selected once, and can be
+		*        overridden by Simd::select or by the ISOLATION_FOREST_ISA environment variable (scalar, avx2, avx512).
+		**/
+		namespace Simd {
+			/**
+			* \brief instruction sets, ordered by preference
+			**/
+			enum class Isa : std::uint8_t { scalar, avx2, avx512 };
+
+			/**
+			* \brief best instruction set supported by both cpu and build
+			* @param {Isa, out} instruction set
+			**/
+			inline Isa detect() noexcept {
+#if defined(ISOLATION_FOREST_AVX512)
+#if defined(__GNUC__) || defined(__clang__)
+				if (__builtin_cpu_supports("avx512f")) {
+					return Isa::avx512;
+				}
+#else
+				return Isa::avx512;
+#endif
+#endif
+#if defined(ISOLATION_FOREST_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+				if (__builtin_cpu_supports("avx2")) {
+					return Isa::avx2;
+				}
+#else
+				return Isa::avx2;
+#endif
+#endif
+				return Isa::scalar;
+			}
+
+			/**
+			* \brief instruction set in use, initialized on first use from the environment override or cpu
+			**/
+			inline std::atomic<Isa>& active() noexcept {
+				static std::atomic<Isa> isa{ []() {
+					const Isa best{ detect() };
+					const char* name{ std::getenv("ISOLATION_FOREST_ISA") };
+					const std::string_view requested{ (name != nullptr) ? name : "" };
+					const Isa wanted{ (requested == "scalar") ? Isa::scalar :
+					                  (requested == "avx2")   ? Isa::avx2 :
+					                  (requested == "avx512") ? Isa::avx512 : best };
+					return std::min(wanted, best);
+				}() };
+				return isa;
+			}
+
+			/**
+			* \brief return instruction set in use
+			* @param {Isa, out} instruction set
+			**/
+			inline Isa isa() noexcept {
+				return active().load(std::memory_order_relaxed);
+			}
+
+			/**
+			* \brief select instruction set (e.g. to compare kernels on one machine), limited to the best supported one
+			* @param {Isa, in}  requested instruction set
+			* @param {Isa, out} instruction set in use
+			**/
+			inline Isa select(const Isa requested) noexcept {
+				const Isa selected{ std::min(requested, detect()) };
+				active().store(selected, std::memory_order_relaxed);
+				return selected;
+			}
+
+#if defined(ISOLATION_FOREST_AVX512)
+			namespace Avx512 {
+				// horizontal reductions (outside of hot loops, so done through memory)
+				template<typename T, typename V>
+				ISOLATION_FOREST_TARGET("avx512f") inline T reduce_min(const V v) noexcept {
+					alignas(64) std::array<T, sizeof(V) / sizeof(T)> lanes;
+					std::memcpy(lanes.data(), &v, sizeof(V));
+					return *std::min_element(lanes.begin(), lanes.end());
+				}
+				template<typename T, typename V>
+				ISOLATION_FOREST_TARGET("avx512f") inline T reduce_max(const V v) noexcept {
+					alignas(64) std::array<T, sizeof(V) / sizeof(T)> lanes;
+					std::memcpy(lanes.data(), &v, sizeof(V));
+					return *std::max_element(lanes.begin(), lanes.end());
+				}
+
+				ISOLATION_FOREST_TARGET("avx512f") inline std::size_t partition(std::span<double> range, const double pivot, std::span<double> scratch,
+					                         std::size_t& left, std::size_t& right, Partition<double>& result) noexcept {
+					const __m512d p{ _mm512_set1_pd(pivot) };
+					__m512d left_min{ _mm512_set1_pd(result.left_min) };
+					__m512d left_max{ _mm512_set1_pd(result.left_max) };
+					__m512d right_min{ _mm512_set1_pd(result.right_min) };
+					__m512d right_max{ _mm512_set1_pd(result.right_max) };
+
+					std::size_t i{};
+					for (; i + 8 <= range.size(); i += 8) {
+						const __m512d v{ _mm512_loadu_pd(range.data() + i) };
+						const __mmask8 smaller{ _mm512_cmp_pd_mask(v, p, _CMP_LT_OQ) };
+						_mm512_mask_compressstoreu_pd(range.data() + left, smaller, v);
+						_mm512_mask_compressstoreu_pd(scratch.data() + right, static_cast<__mmask8>(~smaller), v);
+						left += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(smaller)));
+						right += 8 - static_cast<std::size_t>(std::popcount(static_cast<unsigned>(smaller)));
+						// min/max return their second operand on NaN (and on zeros), so keeping the extreme there matches std::min/std::max
+						left_min = _mm512_mask_min_pd(left_min, smaller, v, left_min);
+						left_max = _mm512_mask_max_pd(left_max, smaller, v, left_max);
+						right_min = _mm512_mask_min_pd(right_min, static_cast<__mmask8>(~smaller), v, right_min);
+						right_max = _mm512_mask_max_pd(right_max, static_cast<__mmask8>(~smaller), v, right_max);
+					}
+
+					result.left_min = reduce_min<double>(left_min);
+					result.left_max = reduce_max<double>(left_max);
+					result.right_min = reduce_min<double>(right_min);
+					result.right_max = reduce_max<double>(right_max);
+					return i;
+				}
+
+				ISOLATION_FOREST_TARGET("avx512f") inline std::size_t partition(std::span<float> range, const float pivot, std::span<float> scratch,
+					                         std::size_t& left, std::size_t& right, Partition<float>& result) noexcept {
+					const __m512 p{ _mm512_set1_ps(pivot) };
+					__m512 left_min{ _mm512_set1_ps(result.left_min) };
+					__m512 left_max{ _mm512_set1_ps(result.left_max) };
+					__m512 right_min{ _mm512_set1_ps(result.right_min) };
+					__m512 right_max{ _mm512_set1_ps(result.right_max) };
+
+					std::size_t i{};
+					for (; i + 16 <= range.size(); i += 16) {
+						const __m512 v{ _mm512_loadu_ps(range.data() + i) };
+						const __mmask16 smaller{ _mm512_cmp_ps_mask(v, p, _CMP_LT_OQ) };
+						_mm512_mask_compressstoreu_ps(range.data() + left, smaller, v);
+						_mm512_mask_compressstoreu_ps(scratch.data() + right, static_cast<__mmask16>(~smaller), v);
+						left += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(smaller)));
+						right += 16 - static_cast<std::size_t>(std::popcount(static_cast<unsigned>(smaller)));
+						// keep the extreme as second operand, see above
+						left_min = _mm512_mask_min_ps(left_min, smaller, v, left_min);
+						left_max = _mm512_mask_max_ps(left_max, smaller, v, left_max);
+						right_min = _mm512_mask_min_ps(right_min, static_cast<__mmask16>(~smaller), v, right_min);
+						right_max = _mm512_mask_max_ps(right_max, static_cast<__mmask16>(~smaller), v, right_max);
+					}
+
+					result.left_min = reduce_min<float>(left_min);
+					result.left_max = reduce_max<float>(left_max);
+					result.right_min = reduce_min<float>(right_min);
+					result.right_max = reduce_max<float>(right_max);
+					return i;
+				}
+
+				ISOLATION_FOREST_TARGET("avx512f") inline std::size_t rank(const double* line, const unsigned lanes, const double value) noexcept {
+					const __mmask8 passed{ _mm512_mask_cmp_pd_mask(static_cast<__mmask8>(lanes), _mm512_set1_pd(value), _mm512_load_pd(line), _CMP_NLT_UQ) };
+					return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(passed)));
+				}
+
+				ISOLATION_FOREST_TARGET("avx512f") inline std::size_t rank(const float* line, const unsigned lanes, const float value) noexcept {
+					const __mmask16 passed{ _mm512_mask_cmp_ps_mask(static_cast<__mmask16>(lanes), _mm512_set1_ps(value), _mm512_load_ps(line), _CMP_NLT_UQ) };
+					return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(passed)));
+				}
+			};
+#endif
+
+#if defined(ISOLATION_FOREST_AVX2)
+			namespace Avx2 {
+				// lane permutations moving the lanes selected by a mask to the front of a vector of eight 32bit lanes
+				template<std::size_t LANES>
+				inline constexpr auto compress_permutations = []() {
+					constexpr std::size_t width{ 8 / LANES };
+					std::array<std::array<std::int32_t, 8>, (1u << LANES)> permutations{};
+					for (std::size_t mask{}; mask < permutations.size(); ++mask) {
+						std::size_t k{};
+						for (std::size_t lane{}; lane < LANES; ++lane) {
+							if (mask & (std::size_t{ 1 } << lane)) {
+								for (std::size_t w{}; w < width; ++w) {
+									permutations[mask][k++] = static_cast<std::int32_t>(lane * width + w);
+								}
+							}
+						}
+						for (; k < 8; ++k) {
+							permutations[mask][k] = static_cast<std::int32_t>(k);
+						}
+					}
+					return permutations;
+				}();
+
+				// horizontal reductions
+				ISOLATION_FOREST_TARGET("avx2") inline double reduce_min(const __m256d v) noexcept {
+					const __m128d half{ _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)) };
+					return _mm_cvtsd_f64(_mm_min_sd(half, _mm_unpackhi_pd(half, half)));
+				}
+				ISOLATION_FOREST_TARGET("avx2") inline double reduce_max(const __m256d v) noexcept {
+					const __m128d half{ _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)) };
+					return _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+				}
+				ISOLATION_FOREST_TARGET("avx2") inline float reduce_min(const __m256 v) noexcept {
+					__m128 half{ _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)) };
+					half = _mm_min_ps(half, _mm_movehl_ps(half, half));
+					return _mm_cvtss_f32(_mm_min_ss(half, _mm_shuffle_ps(half, half, 1)));
+				}
+				ISOLATION_FOREST_TARGET("avx2") inline float reduce_max(const __m256 v) noexcept {
+					__m128 half{ _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)) };
+					half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+					return _mm_cvtss_f32(_mm_max_ss(half, _mm_shuffle_ps(half, half, 1)));
+				}
+
+				ISOLATION_FOREST_TARGET("avx2") inline std::size_t partition(std::span<double> range, const double pivot, std::span<double> scratch,
+					                         std::size_t& left, std::size_t& right, Partition<double>& result) noexcept {
+					const __m256d p{ _mm256_set1_pd(pivot) };
+					const __m256d inf{ _mm256_set1_pd(std::numeric_limits<double>::infinity()) };
+					const __m256d negative_inf{ _mm256_set1_pd(-std::numeric_limits<double>::infinity()) };
+					__m256d left_min{ _mm256_set1_pd(result.left_min) };
+					__m256d left_max{ _mm256_set1_pd(result.left_max) };
+					__m256d right_min{ _mm256_set1_pd(result.right_min) };
+					__m256d right_max{ _mm256_set1_pd(result.right_max) };
+
+					// notice that full vector stores never pass the current vector, since left <= i and right <= i
+					std::size_t i{};
+					for (; i + 4 <= range.size(); i += 4) {
+						const __m256d v{ _mm256_loadu_pd(range.data() + i) };
+						const __m256d smaller{ _mm256_cmp_pd(v, p, _CMP_LT_OQ) };
+						const unsigned mask{ static_cast<unsigned>(_mm256_movemask_pd(smaller)) };
+						const __m256i to_left{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress_permutations<4>[mask].data())) };
+						const __m256i to_right{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress_permutations<4>[~mask & 0xF].data())) };
+						_mm256_storeu_pd(range.data() + left, _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), to_left)));
+						_mm256_storeu_pd(scratch.data() + right, _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), to_right)));
+						left += static_cast<std::size_t>(std::popcount(mask));
+						right += 4 - static_cast<std::size_t>(std::popcount(mask));
+						// min/max return their second operand on NaN (and on zeros), so keeping the extreme there matches std::min/std::max
+						left_min = _mm256_min_pd(_mm256_blendv_pd(inf, v, smaller), left_min);
+						left_max = _mm256_max_pd(_mm256_blendv_pd(negative_inf, v, smaller), left_max);
+						right_min = _mm256_min_pd(_mm256_blendv_pd(v, inf, smaller), right_min);
+						right_max = _mm256_max_pd(_mm256_blendv_pd(v, negative_inf, smaller), right_max);
+					}
+
+					result.left_min = reduce_min(left_min);
+					result.left_max = reduce_max(left_max);
+					result.right_min = reduce_min(right_min);
+					result.right_max = reduce_max(right_max);
+					return i;
+				}
+
+				ISOLATION_FOREST_TARGET("avx2") inline std::size_t partition(std::span<float> range, const float pivot, std::span<float> scratch,
+					                         std::size_t& left, std::size_t& right, Partition<float>& result) noexcept {
+					const __m256 p{ _mm256_set1_ps(pivot) };
+					const __m256 inf{ _mm256_set1_ps(std::numeric_limits<float>::infinity()) };
+					const __m256 negative_inf{ _mm256_set1_ps(-std::numeric_limits<float>::infinity()) };
+					__m256 left_min{ _mm256_set1_ps(result.left_min) };
+					__m256 left_max{ _mm256_set1_ps(result.left_max) };
+					__m256 right_min{ _mm256_set1_ps(result.right_min) };
+					__m256 right_max{ _mm256_set1_ps(result.right_max) };
+
+					// notice that full vector stores never pass the current vector, since left <= i and right <= i
+					std::size_t i{};
+					for (; i + 8 <= range.size(); i += 8) {
+						const __m256 v{ _mm256_loadu_ps(range.data() + i) };
+						const __m256 smaller{ _mm256_cmp_ps(v, p, _CMP_LT_OQ) };
+						const unsigned mask{ static_cast<unsigned>(_mm256_movemask_ps(smaller)) };
+						const __m256i to_left{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress_permutations<8>[mask].data())) };
+						const __m256i to_right{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress_permutations<8>[~mask & 0xFF].data())) };
+						_mm256_storeu_ps(range.data() + left, _mm256_permutevar8x32_ps(v, to_left));
+						_mm256_storeu_ps(scratch.data() + right, _mm256_permutevar8x32_ps(v, to_right));
+						left += static_cast<std::size_t>(std::popcount(mask));
+						right += 8 - static_cast<std::size_t>(std::popcount(mask));
+						// keep the extreme as second operand, see above
+						left_min = _mm256_min_ps(_mm256_blendv_ps(inf, v, smaller), left_min);
+						left_max = _mm256_max_ps(_mm256_blendv_ps(negative_inf, v, smaller), left_max);
+						right_min = _mm256_min_ps(_mm256_blendv_ps(v, inf, smaller), right_min);
+						right_max = _mm256_max_ps(_mm256_blendv_ps(v, negative_inf, smaller), right_max);
+					}
+
+					result.left_min = reduce_min(left_min);
+					result.left_max = reduce_max(left_max);
+					result.right_min = reduce_min(right_min);
+					result.right_max = reduce_max(right_max);
+					return i;
+				}
+
+				ISOLATION_FOREST_TARGET("avx2") inline std::size_t rank(const double* line, const unsigned lanes, const double value) noexcept {
+					const __m256d v{ _mm256_set1_pd(value) };
+					const unsigned low{ static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, _mm256_load_pd(line), _CMP_NLT_UQ))) };
+					const unsigned high{ static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(v, _mm256_load_pd(line + 4), _CMP_NLT_UQ))) };
+					return static_cast<std::size_t>(std::popcount((low | (high << 4)) & lanes));
+				}
+
+				ISOLATION_FOREST_TARGET("avx2") inline std::size_t rank(const float* line, const unsigned lanes, const float value) noexcept {
+					const __m256 v{ _mm256_set1_ps(value) };
+					const unsigned low{ static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_load_ps(line), _CMP_NLT_UQ))) };
+					const unsigned high{ static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_load_ps(line + 8), _CMP_NLT_UQ))) };
+					return static_cast<std::size_t>(std::popcount((low | (high << 8)) & lanes));
+				}
+			};
+#endif
+
+			/**
+			* \brief hint the cpu to fetch the cache line of an address
+			* @param {pointer, in} address
+			**/
+			inline void prefetch([[maybe_unused]] const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+				__builtin_prefetch(address);
+#elif defined(ISOLATION_FOREST_AVX2)
+				_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+			}
+
+			/**
+			* \brief run the kernel of the instruction set in use
+			**/
+			template<typename T>
+			inline std::size_t partition(std::span<T> range, const T pivot, std::span<T> scratch,
+				                         std::size_t& left, std::size_t& right, Partition<T>& result) noexcept {
+				switch (isa()) {
+#if defined(ISOLATION_FOREST_AVX512)
+					case Isa::avx512:
+						return Avx512::partition(range, pivot, scratch, left, right, result);
+#endif
+#if defined(ISOLATION_FOREST_AVX2)
+					case Isa::avx2:
+						return Avx2::partition(range, pivot, scratch, left, right, result);
+#endif
+					default:
+						// scalar, nothing is vectorized
+						return 0;
+				}
+			}
+
+			/**
+			* \brief count the first N thresholds of a 64 byte aligned cache line which value is not smaller than,
+			*        with the kernel of the instruction set in use (the rest of the line is not compared)
+			* @param {pointer, in}  first threshold of cache line
+			* @param {T,       in}  value
+			* @param {size_t,  out} amount of thresholds which value is not smaller than
+			**/
+			template<std::size_t N, typename T>
+				requires(N * sizeof(T) < 64)
+			inline std::size_t rank(const T* line, const T value) noexcept {
+				if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+					constexpr unsigned lanes{ (1u << N) - 1 };
+					switch (isa()) {
+#if defined(ISOLATION_FOREST_AVX512)
+						case Isa::avx512:
+							return Avx512::rank(line, lanes, value);
+#endif
+#if defined(ISOLATION_FOREST_AVX2)
+						case Isa::avx2:
+							return Avx2::rank(line, lanes, value);
+#endif
+						default:
+							break;
+					}
+				}
+
+				std::size_t count{};
+				for (std::size_t i{}; i < N; ++i) {
+					count += !(value < line[i]);
+				}
+				return count;
+			}
+		};
+
+		/**
+		* \brief partition of a range which also returns the extremes of both sides.
+		*        with a vector kernel (see Simd) the partition is branch free and stable: elements smaller than pivot
+		*        keep their order at the front of the range, followed by the other elements in their order.
+		*        without one (scalar instruction set, constant evaluation, or a range shorter than a vector) it is
+		*        std::partition, whose predicate (applied exactly once per element) accumulates the extremes, since
+		*        the branchy loop outruns a branch free scalar loop. the order within each side is then unspecified.
+		* @param {span,      in|out} range
+		* @param {T,         in}     pivot
+		* @param {span,      in}     scratch buffer, at least as large as range
+		* @param {Partition, out}    partition point and extremes of both sides
+		**/
+		template<typename T>
+		constexpr Partition<T> partition(std::span<T> range, const T pivot, std::span<T> scratch) noexcept {
+			Partition<T> result;
+			std::size_t left{};
+			std::size_t right{};
+			std::size_t i{};
+
+			if (!std::is_constant_evaluated()) {
+				i = Simd::partition(range, pivot, scratch, left, right, result);
+			}
+			if (i == 0) {
+				const auto mid = std::partition(range.begin(), range.end(), [pivot, &result](const T v) {
+					const bool smaller{ v < pivot };
+					result.left_min = std::min(result.left_min, smaller ? v : result.left_min);
+					result.left_max = std::max(result.left_max, smaller ? v : result.left_max);
+					result.right_min = std::min(result.right_min, smaller ? result.right_min : v);
+					result.right_max = std::max(result.right_max, smaller ? result.right_max : v);
+					return smaller;
+				});
+				result.mid = static_cast<std::size_t>(mid - range.begin());
+				return result;
+			}
+
+			// tail of the vector kernel, appended to its sides
+			for (; i < range.size(); ++i) {
+				const T v{ range[i] };
+				const bool smaller{ v < pivot };
+				range[left] = v;
+				scratch[right] = v;
+				left += smaller;
+				right += !smaller;
+				result.left_min = std::min(result.left_min, smaller ? v : result.left_min);
+				result.left_max = std::max(result.left_max, smaller ? v : result.left_max);
+				result.right_min = std::min(result.right_min, smaller ? result.right_min : v);
+				result.right_max = std::max(result.right_max, smaller ? result.right_max : v);
+			}
+			std::copy(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(right), range.begin() + static_cast<std::ptrdiff_t>(left));
+
+			result.mid = left;
+			return result;
+		}
+
+		/**
+		* \brief outcome of a node split
+		**/
+		template<typename T, typename I>
+		struct Split {
+			T anchor{};       // split value
+			I mid{};          // index of first element which is not smaller than anchor
+			bool valid{};     // false if range can not be split (all its elements are equal)
+			T left_min{};     // extremes of data[left, mid)
+			T left_max{};
+			T right_min{};    // extremes of data[mid, right)
+			T right_max{};
+		};
+
+		/**
+		* \brief draw a split value uniformly between range extremes
+		* @param {floating_point, in}  range minimum
+		* @param {floating_point, in}  range maximum
+		* @param {Random,         in}  node random stream
+		* @param {floating_point, out} split value
+		**/
+		template<typename T>
+		constexpr T draw_anchor(const T min, const T max, Random random) {
+			const T ratio{ static_cast<T>(static_cast<double>(random.next() >> 11) * 0x1.0p-53) };
+			return min + ratio * (max - min);
+		}
+
+		/**
+		* \brief partition data[left, right) around an anchor uniformly drawn between the range extremes
+		* @param {span,           in|out} data
+		* @param {span,           in}     scratch buffer, as large as data
+		* @param {integral,       in}     index of first element in range
+		* @param {integral,       in}     index one past the last element in range
+		* @param {floating_point, in}     range minimum
+		* @param {floating_point, in}     range maximum
+		* @param {Random,         in}     node random stream
+		* @param {Split,          out}    anchor, partition point and extremes of both sides
+		**/
+		template<typename T, typename I>
+		constexpr Split<T, I> split(std::span<T> data, std::span<T> scratch, const I left, const I right, const T min, const T max, Random random) {
+			if (!(min < max)) [[unlikely]] {
+				return Split<T, I>{};
+			}
+
+			const T anchor{ draw_anchor(min, max, random) };
+			const std::size_t first{ static_cast<std::size_t>(left) };
+			const std::size_t count{ static_cast<std::size_t>(right - left) };
+			const Partition<T> partition{ Implementation::partition(data.subspan(first, count), anchor, scratch.subspan(first, count)) };
+
+			return Split<T, I>{ .anchor = anchor, .mid = static_cast<I>(first + partition.mid), .valid = true,
+				                .left_min = partition.left_min, .left_max = partition.left_max,
+				                .right_min = partition.right_min, .right_max = partition.right_max };
+		}
+
+		/**
+		* \brief work stealing thread pool shared by the parallel stages of this library.
+		*        every worker owns a task deque; it executes its own tasks last in first out and,
+		*        once it runs dry, steals the oldest tasks of other workers. threads which wait for
+		*        a task group execute pending tasks meanwhile, so nested (recursive) task groups do
+		*        not deadlock and the pool is never oversubscribed. an exception thrown by a task is
+		*        rethrown by the wait on its group.
+		**/
+		struct ThreadPool {
+			/**
+			* \brief set of tasks which can be waited upon
+			**/
+			struct TaskGroup {
+				std::atomic<std::size_t> pending{};
+				std::mutex failure_mutex;
+				std::exception_ptr failure;   // first exception thrown by a task of the group
+			};
+
+			/**
+			* \brief construct pool
+			* @param {size_t, in} amount of workers
+			* @param {bool,   in} if true, worker i is pinned to cpu (i % hardware concurrency), linux only
+			**/
+			explicit ThreadPool(const std::size_t size = std::max(std::thread::hardware_concurrency(), 1u), [[maybe_unused]] const bool pin = false) {
+				for (std::size_t i{}; i < std::max(size, std::size_t{ 1 }); ++i) {
+					this->queues.push_back(std::make_unique<Queue>());
+				}
+				for (std::size_t i{}; i < this->queues.size(); ++i) {
+					this->workers.emplace_back([this, i]() { this->work(i); });
+#if defined(__linux__)
+					if (pin) {
+						cpu_set_t cpus;
+						CPU_ZERO(&cpus);
+						CPU_SET(i % std::max(std::thread::hardware_concurrency(), 1u), &cpus);
+						pthread_setaffinity_np(this->workers.back().native_handle(), sizeof(cpu_set_t), &cpus);
+					}
+#endif
+				}
+			}
+
+			// ThreadPool is not copyable
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool(ThreadPool&&) = delete;
+			ThreadPool& operator =(const ThreadPool&) = delete;
+			ThreadPool& operator =(ThreadPool&&) = delete;
+
+			~ThreadPool() {
+				{
+					std::lock_guard<std::mutex> lock(this->sleep_mutex);
+					this->stopping = true;
+				}
+				this->wake.notify_all();
+				for (auto& worker : this->workers) {
+					worker.join();
+				}
+			}
+
+			/**
+			* \brief return amount of workers
+			* @param {size_t, out} amount of workers
+			**/
+			std::size_t size() const {
+				return this->workers.size();
+			}
+
+			/**
+			* \brief submit a task as part of a task group.
+			*        tasks submitted from a worker go to its own deque, other tasks are spread round robin.
+			* @param {TaskGroup, in} group the task belongs to
+			* @param {callable,  in} task
+			**/
+			template<class F>
+			void submit(TaskGroup& group, F&& task) {
+				group.pending.fetch_add(1, std::memory_order_relaxed);
+				const Worker& self{ ThreadPool::current() };
+				const std::size_t index{ (self.pool == this) ? self.index : this->next.fetch_add(1, std::memory_order_relaxed) % this->queues.size() };
+
+				// count the task before it can be taken, so the count never drops below zero
+				{
+					std::lock_guard<std::mutex> lock(this->sleep_mutex);
+					this->queued.fetch_add(1, std::memory_order_release);
+				}
+				{
+					std::lock_guard<std::mutex> lock(this->queues[index]->mutex);
+					this->queues[index]->tasks.emplace_back([this, &group, task = std::forward<F>(task)]() mutable {
+						try {
+							task();
+						} catch (...) {
+							std::lock_guard<std::mutex> lock(group.failure_mutex);
+							if (!group.failure) {
+								group.failure = std::current_exception();
+							}
+						}
+
+						// the group may be gone once its last task is done, so only the pool is touched afterwards
+						if (group.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+							{
+								std::lock_guard<std::mutex> lock(this->sleep_mutex);
+							}
+							this->wake.notify_all();
+						}
+					});
+				}
+				this->wake.notify_one();
+			}
+
+			/**
+			* \brief wait until all tasks of a group are done, executing pending tasks meanwhile.
+			*        sleeps while no task is pending, and rethrows the first exception a task of the group threw.
+			* @param {TaskGroup, in} group
+			**/
+			void wait(TaskGroup& group) {
+				while (group.pending.load(std::memory_order_acquire) > 0) {
+					if (this->run_one()) {
+						continue;
+					}
+
+					std::unique_lock<std::mutex> lock(this->sleep_mutex);
+					this->wake.wait(lock, [this, &group]() {
+						return group.pending.load(std::memory_order_acquire) == 0 || this->queued.load(std::memory_order_acquire) > 0;
+					});
+				}
+
+				if (group.failure) {
+					std::rethrow_exception(std::exchange(group.failure, nullptr));
+				}
+			}
+
+			/**
+			* \brief invoke f(first, last) over consecutive chunks of [0, count) and wait for all of them
+			* @param {size_t,   in} amount of indices
+			* @param {size_t,   in} maximal chunk size
+			* @param {callable, in} chunk function
+			**/
+			template<class F>
+			void parallel_for(const std::size_t count, const std::size_t grain, F&& f) {
+				TaskGroup group;
+				const std::size_t chunk{ std::max(grain, std::size_t{ 1 }) };
+				for (std::size_t first{}; first < count; first += chunk) {
+					this->submit(group, [&f, first, last = std::min(first + chunk, count)]() { f(first, last); });
+				}
+				this->wait(group);
+			}
+
+			// internals
+			private:
+				using task_type = std::function<void()>;
+
+				// worker task deque
+				struct Queue {
+					std::mutex mutex;
+					std::deque<task_type> tasks;
+				};
+
+				// identity of a worker thread
+				struct Worker {
+					const ThreadPool* pool{ nullptr };
+					std::size_t index{};
+				};
+
+				// properties
+				std::vector<std::unique_ptr<Queue>> queues;
+				std::vector<std::thread> workers;
+				std::atomic<std::size_t> next{};
+				std::atomic<std::size_t> queued{};
+				std::mutex sleep_mutex;
+				std::condition_variable wake;
+				bool stopping{ false };
+
+				/**
+				* \brief identity of calling thread
+				**/
+				static Worker& current() {
+					thread_local Worker worker;
+					return worker;
+				}
+
+				/**
+				* \brief worker loop
+				**/
+				void work(const std::size_t index) {
+					ThreadPool::current() = Worker{ .pool = this, .index = index };
+
+					while (true) {
+						if (this->run_one()) {
+							continue;
+						}
+
+						std::unique_lock<std::mutex> lock(this->sleep_mutex);
+						this->wake.wait(lock, [this]() { return this->stopping || this->queued.load(std::memory_order_acquire) > 0; });
+						if (this->stopping && this->queued.load(std::memory_order_acquire) == 0) {
+							return;
+						}
+					}
+				}
+
+				/**
+				* \brief execute one pending task: newest task of own deque, otherwise oldest task of another deque
+				* @param {bool, out} false if no task was pending
+				**/
+				bool run_one() {
+					const Worker& self{ ThreadPool::current() };
+					const bool is_worker{ self.pool == this };
+					task_type task;
+
+					if (is_worker) {
+						Queue& own{ *this->queues[self.index] };
+						std::lock_guard<std::mutex> lock(own.mutex);
+						if (!own.tasks.empty()) {
+							task = std::move(own.tasks.back());
+							own.tasks.pop_back();
+						}
+					}
+
+					const std::size_t start{ is_worker ? self.index + 1 : 0 };
+					for (std::size_t i{}; !task && i < this->queues.size(); ++i) {
+						Queue& victim{ *this->queues[(start + i) % this->queues.size()] };
+						std::lock_guard<std::mutex> lock(victim.mutex);
+						if (!victim.tasks.empty()) {
+							task = std::move(victim.tasks.front());
+							victim.tasks.pop_front();
+						}
+					}
+
+					if (!task) {
+						return false;
+					}
+					this->queued.fetch_sub(1, std::memory_order_acq_rel);
+					task();
+					return true;
+				}
+		};
+
+		/**
+		* \brief depth of every node of a tree whose root is the last node
+		* @param {vector, in}  nodes
+		* @param {vector, out} node depths
+		**/
+		template<Interface::INode Node>
+		constexpr std::vector<typename Node::size_type> node_depths(const std::vector<Node>& nodes) {
+			std::vector<typename Node::size_type> depths(nodes.size());
+			if (nodes.empty()) [[unlikely]] {
+				return depths;
+			}
+
+			std::vector<std::size_t> stack{ nodes.size() - 1 };
+			while (!stack.empty()) {
+				const std::size_t i{ stack.back() };
+				stack.pop_back();
+				const Node& node{ nodes[i] };
+				if (node.left >= 0) {
+					depths[static_cast<std::size_t>(node.left)] = depths[i] + 1;
+					stack.push_back(static_cast<std::size_t>(node.left));
+				}
+				if (node.right >= 0) {
+					depths[static_cast<std::size_t>(node.right)] = depths[i] + 1;
+					stack.push_back(static_cast<std::size_t>(node.right));
+				}
+			}
+			return depths;
+		}
+
+		/**
+		* \brief Interface::ITree implementation
+		**/
+		template<Interface::INode Node>
+		struct ITree {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+			using tree_type = std::vector<node_type>;
+
+			/**
+			* \brief construct ITree with predefined maximal depth
+			* @param {size_type, in} maximal depth
+			* @param {uint64_t,  in} random seed
+			**/
+			constexpr explicit ITree(size_type _max_depth, std::uint64_t _seed = 0) : max_depth(_max_depth), seed(_seed) {
+				this->tree.reserve(static_cast<std::size_t>((_max_depth > 100) ? _max_depth * (_max_depth / 100) : _max_depth));
+			}
+
+			// ITree is regular
+			ITree(const ITree&) = default;
+			ITree(ITree&&) = default;
+			ITree& operator =(const ITree&) = delete;
+			ITree& operator =(ITree&&) = delete;
+			~ITree() = default;
+
+			/**
+			* \brief return root node id
+			* @param {size_t, out} tree root node id
+			**/
+			constexpr size_type root_id() const {
+				return static_cast<size_type>(this->tree.size() - 1);
+			};
+
+			/**
+			* \brief return amount of nodes in tree
+			* @param {size_t, out} amount of nodes
+			**/
+			constexpr std::size_t node_count() const {
+				return this->tree.size();
+			}
+
+			/**
+			* \brief return tree nodes (root is last, post order unless grown by insert)
+			* @param {tree_type, out} nodes
+			**/
+			constexpr const tree_type& nodes() const {
+				return this->tree;
+			}
+
+			/**
+			* \brief insert a value into the tree: route it to its leaf and add to the leaf mass. a leaf whose
+			*        mass exceeds capacity is split at a value drawn uniformly between the extremes seen by it,
+			*        and its mass is divided between its children in proportion to their share of that range.
+			*        with decay below 1, all leaf masses are multiplied by decay before every insertion.
+			*        leaves of a built tree start with no mass. an insertion visits the path of the value (and the
+			*        levels between shortest and longest path), and only allocates when the tree grows a level.
+			*        throws std::invalid_argument if decay is not in (0, 1].
+			* @param {value_type, in} value
+			* @param {value_type, in} leaf capacity
+			* @param {value_type, in} mass decay factor per insertion
+			**/
+			constexpr void insert(const value_type value, const value_type capacity, const value_type decay = value_type{ 1 }) {
+				if (!(decay > value_type{} && decay <= value_type{ 1 })) [[unlikely]] {
+					throw std::invalid_argument("IsolationForest: decay must be in (0, 1]");
+				}
+				if (this->tree.empty()) [[unlikely]] {
+					this->tree.push_back(node_type{});
+					this->update_bounds();
+				}
+				if (this->leaves.size() != this->tree.size()) [[unlikely]] {
+					this->leaves.resize(this->tree.size());
+				}
+
+				// masses are stored scaled by 1 / decay^t, so decaying all of them is a single multiplication
+				this->weight /= decay;
+				if (this->weight > static_cast<value_type>(0x1.0p64)) [[unlikely]] {
+					for (Leaf& leaf : this->leaves) {
+						leaf.mass /= this->weight;
+					}
+					this->total /= this->weight;
+					this->weight = value_type{ 1 };
+				}
+				this->total += this->weight;
+
+				// route to leaf
+				std::size_t index{ this->tree.size() - 1 };
+				size_type depth{};
+				while (this->tree[index].left >= 0) {
+					const node_type& node{ this->tree[index] };
+					index = static_cast<std::size_t>((value < node.split_value) ? node.left : node.right);
+					++depth;
+				}
+
+				Leaf& leaf{ this->leaves[index] };
+				leaf.mass += this->weight;
+				leaf.min = std::min(leaf.min, value);
+				leaf.max = std::max(leaf.max, value);
+				if (leaf.mass <= capacity * this->weight || depth >= this->max_depth || !(leaf.min < leaf.max)) {
+					return;
+				}
+
+				// split leaf, children are appended and root is moved to remain last
+				const value_type anchor{ draw_anchor(leaf.min, leaf.max, Random{ this->seed }.fork(2).fork(this->tree.size())) };
+				const value_type share{ (anchor - leaf.min) / (leaf.max - leaf.min) };
+				const Leaf left{ .mass = leaf.mass * share, .min = leaf.min, .max = anchor };
+				const Leaf right{ .mass = leaf.mass - left.mass, .min = anchor, .max = leaf.max };
+				const std::size_t root{ this->tree.size() - 1 };
+				const std::size_t split{ (index == root) ? root + 2 : index };
+				const node_type root_node{ this->tree[root] };
+				this->tree[root] = node_type{};
+				this->tree.push_back(node_type{});
+				this->tree.push_back(root_node);
+				this->leaves.resize(this->tree.size());
+				this->leaves[root] = left;
+				this->leaves[root + 1] = right;
+				this->leaves[split] = Leaf{};
+				this->tree[split] = node_type{ .split_value = anchor, .left = static_cast<size_type>(root), .right = static_cast<size_type>(root + 1) };
+
+				// the leaf at 'depth' is replaced by two leaves one level below
+				const std::size_t level{ static_cast<std::size_t>(depth) };
+				if (this->level_leaves.size() < level + 2) {
+					this->level_leaves.resize(level + 2);
+				}
+				--this->level_leaves[level];
+				this->level_leaves[level + 1] += 2;
+				this->longest = std::max(this->longest, static_cast<value_type>(depth));
+				std::size_t shortest_level{ static_cast<std::size_t>(this->shortest + value_type{ 1 }) };
+				while (this->level_leaves[shortest_level] == 0) {
+					++shortest_level;
+				}
+				this->shortest = static_cast<value_type>(shortest_level) - value_type{ 1 };
+			}
+
+			/**
+			* \brief return amount of values held by the tree (samples it was built from and inserted values),
+			*        decayed as leaf masses are
+			* @param {value_type, out} amount of values
+			**/
+			constexpr value_type mass() const {
+				return this->total / this->weight;
+			}
+
+			/**
+			* \brief return shortest path length in tree
+			* @param {value_type, out} shortest path length
+			**/
+			constexpr value_type min_path_length() const {
+				return this->shortest;
+			}
+
+			/**
+			* \brief return longest path length in tree
+			* @param {value_type, out} longest path length
+			**/
+			constexpr value_type max_path_length() const {
+				return this->longest;
+			}
+
+			/**
+			* \brief build tree from data given by range iterators to a given collection
+			*        notice that this function is recursive.
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			constexpr void build(It first, It last) {
+				this->build(first, last, std::span<value_type>{});
+			}
+
+			/**
+			* \brief build tree from data given by range iterators to a given collection,
+			*        and add the path length of every sample to 'paths'.
+			*        samples are addressed by their rank, i.e. paths[i] belongs to the i'th smallest sample
+			*        (samples which are equal share their path length).
+			* @param {forward_iterator, in}     iterator for first element in collection
+			* @param {forward_iterator, in}     iterator for last element in collection
+			* @param {span,             in|out} per sample path lengths (empty, or as large as the collection)
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			constexpr void build(It first, It last, std::span<value_type> paths) {
+				std::vector<value_type> data(first, last);
+				std::vector<value_type> scratch(data.size());
+				assert(paths.empty() || paths.size() == data.size());
+				this->tree.clear();
+				this->leaves.clear();
+				this->weight = value_type{ 1 };
+				this->total = static_cast<value_type>(data.size());
+				if (data.empty()) {
+					this->tree.push_back(node_type{});
+					this->update_bounds();
+					return;
+				}
+
+				const auto [min, max] = std::minmax_element(data.begin(), data.end());
+				this->build_recursively(this->tree, data, scratch, paths, size_type{}, static_cast<size_type>(data.size()), size_type{}, Random{ this->seed }, *min, *max);
+				this->update_bounds();
+			}
+
+			/**
+			* \brief build tree in parallel from data given by range iterators to a given collection.
+			*        nodes spanning at least 'grain' samples are partitioned in parallel and their subtrees
+			*        are built as independent tasks, smaller nodes are built serially.
+			*        the tree is identical to the one built serially.
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			* @param {ThreadPool,       in} pool executing partitions and subtree builds
+			* @param {size_t,           in} minimal amount of samples in a node for it to be built in parallel
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			void build(It first, It last, ThreadPool& pool, const std::size_t grain = 1 << 15) {
+				std::vector<value_type> data(first, last);
+				std::vector<value_type> scratch(data.size());
+				this->leaves.clear();
+				this->weight = value_type{ 1 };
+				this->total = static_cast<value_type>(data.size());
+				if (data.empty()) {
+					this->tree = tree_type(1, node_type{});
+					this->update_bounds();
+					return;
+				}
+
+				const auto [min, max] = std::minmax_element(data.begin(), data.end());
+				this->tree = this->build_parallel(data, scratch, size_type{}, static_cast<size_type>(data.size()), size_type{}, Random{ this->seed },
+					                              *min, *max, pool, std::max(grain, std::size_t{ 2 }));
+				this->update_bounds();
+			}
+
+			/**
+			* \brief return the path length of a given value.
+			*        iterative, visits at most max_depth + 1 nodes and does not allocate.
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  node index
+			* @param {size_type,  in}  node depth
+			* @param {value_type, out} path length
+			**/
+			constexpr value_type path_length(const value_type& value, const size_type node_index, const size_type node_depth) const noexcept {
+				assert(node_index >= 0);
+				size_type index{ node_index };
+				size_type depth{ node_depth };
+
+				while (true) {
+					const node_type& node{ this->tree[static_cast<std::size_t>(index)] };
+					if (value < node.split_value && node.left >= 0) {
+						index = node.left;
+					}
+					else if (node.right >= 0) [[likely]] {
+						index = node.right;
+					}
+					else {
+						return static_cast<value_type>(depth - 1);
+					}
+					++depth;
+				}
+			};
+
+			// internals
+			private:
+				// properties
+				tree_type tree;
+				const size_type max_depth;
+				const std::uint64_t seed;
+				value_type shortest{};
+				value_type longest{};
+				std::vector<std::size_t> level_leaves;    // amount of leaves at every depth
+
+				// mass and extremes of values inserted to a leaf
+				struct Leaf {
+					value_type mass{};
+					value_type min{ std::numeric_limits<value_type>::infinity() };
+					value_type max{ -std::numeric_limits<value_type>::infinity() };
+				};
+				std::vector<Leaf> leaves;    // per node, empty until first insertion
+				value_type weight{ 1 };      // mass of an insertion, 1 / decay^t
+				value_type total{};          // amount of values held by tree, scaled as leaf masses
+
+				/**
+				* \brief update shortest and longest path length, and amount of leaves at every depth
+				**/
+				constexpr void update_bounds() {
+					const std::vector<size_type> depths{ node_depths(this->tree) };
+					this->shortest = std::numeric_limits<value_type>::max();
+					this->longest = std::numeric_limits<value_type>::lowest();
+					this->level_leaves.clear();
+					for (std::size_t i{}; i < this->tree.size(); ++i) {
+						if (this->tree[i].left < 0) {
+							const std::size_t level{ static_cast<std::size_t>(depths[i]) };
+							this->level_leaves.resize(std::max(this->level_leaves.size(), level + 1));
+							++this->level_leaves[level];
+							this->shortest = std::min(this->shortest, static_cast<value_type>(depths[i] - 1));
+							this->longest = std::max(this->longest, static_cast<value_type>(depths[i] - 1));
+						}
+					}
+				}
+
+				/**
+				* \brief recursively build tree.
+				*        leaves split data into ranges ordered by value, so leaf data[left, right) holds the samples
+				*        ranked left to right - 1, whose path lengths are added to 'paths' (unless empty).
+				**/
+				constexpr size_type build_recursively(tree_type& nodes, std::span<value_type> data, std::span<value_type> scratch,
+					                                  std::span<value_type> paths, const size_type left, const size_type right,
+					                                  const size_type depth, const Random random,
+					                                  const value_type min, const value_type max) const {
+					const Split<value_type, size_type> split{ (right - left <= 1 || depth >= this->max_depth) ?
+						                                      Split<value_type, size_type>{} :
+						                                      Implementation::split(data, scratch, left, right, min, max, random) };
+
+					if (!split.valid) [[unlikely]] {
+						nodes.push_back(node_type{});
+						for (std::size_t i{ static_cast<std::size_t>(left) }; i < static_cast<std::size_t>(right) && !paths.empty(); ++i) {
+							paths[i] += static_cast<value_type>(depth - 1);
+						}
+					}
+					else {
+						const node_type node{
+							.split_value = split.anchor,
+			                .left = this->build_recursively(nodes, data, scratch, paths, left, split.mid, depth + 1, random.fork(0), split.left_min, split.left_max),
+			                .right = this->build_recursively(nodes, data, scratch, paths, split.mid, right, depth + 1, random.fork(1), split.right_min, split.right_max)
+						};
+
+						nodes.push_back(node);
+					}
+
+					// output
+					return static_cast<size_type>(nodes.size() - 1);
+				}
+
+				/**
+				* \brief build subtree spanning data[left, right) using thread pool.
+				*        returns subtree nodes (post order, root is last, indices relative to subtree).
+				**/
+				tree_type build_parallel(std::span<value_type> data, std::span<value_type> scratch,
+					                     const size_type left, const size_type right,
+					                     const size_type depth, const Random random,
+					                     const value_type min, const value_type max,
+					                     ThreadPool& pool, const std::size_t grain) const {
+					tree_type nodes;
+					const std::size_t count{ static_cast<std::size_t>(right - left) };
+					if (count < grain || depth >= this->max_depth) {
+						this->build_recursively(nodes, data, scratch, std::span<value_type>{}, left, right, depth, random, min, max);
+						return nodes;
+					}
+					if (!(min < max)) [[unlikely]] {
+						nodes.push_back(node_type{});
+						return nodes;
+					}
+
+					const value_type anchor{ draw_anchor(min, max, random) };
+					const std::size_t first{ static_cast<std::size_t>(left) };
+					const std::size_t chunk{ std::max(grain / 8, std::size_t{ 1 }) };
+					const std::size_t chunks{ (count + chunk - 1) / chunk };
+					const auto chunk_begin = [first, chunk](const std::size_t c) { return first + c * chunk; };
+					const auto chunk_end = [first, chunk, count](const std::size_t c) { return first + std::min((c + 1) * chunk, count); };
+
+					// partition every chunk in place
+					std::vector<Partition<value_type>> partitions(chunks);
+					pool.parallel_for(chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+						for (std::size_t c{ begin }; c < end; ++c) {
+							partitions[c] = Implementation::partition(data.subspan(chunk_begin(c), chunk_end(c) - chunk_begin(c)), anchor,
+								                                      scratch.subspan(chunk_begin(c), chunk_end(c) - chunk_begin(c)));
+						}
+					});
+
+					// gather chunk sides to their place in scratch and copy back
+					std::vector<std::size_t> left_offset(chunks);
+					std::vector<std::size_t> right_offset(chunks);
+					std::size_t left_position{ first };
+					std::size_t right_position{ first };
+					for (const auto& partition : partitions) {
+						right_position += partition.mid;
+					}
+					const size_type mid{ static_cast<size_type>(right_position) };
+					Partition<value_type> extremes;
+					for (std::size_t c{}; c < chunks; ++c) {
+						left_offset[c] = left_position;
+						right_offset[c] = right_position;
+						left_position += partitions[c].mid;
+						right_position += chunk_end(c) - chunk_begin(c) - partitions[c].mid;
+						extremes.left_min = std::min(extremes.left_min, partitions[c].left_min);
+						extremes.left_max = std::max(extremes.left_max, partitions[c].left_max);
+						extremes.right_min = std::min(extremes.right_min, partitions[c].right_min);
+						extremes.right_max = std::max(extremes.right_max, partitions[c].right_max);
+					}
+					pool.parallel_for(chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+						for (std::size_t c{ begin }; c < end; ++c) {
+							const auto chunk_mid{ data.begin() + static_cast<std::ptrdiff_t>(chunk_begin(c) + partitions[c].mid) };
+							std::copy(data.begin() + static_cast<std::ptrdiff_t>(chunk_begin(c)), chunk_mid, scratch.begin() + static_cast<std::ptrdiff_t>(left_offset[c]));
+							std::copy(chunk_mid, data.begin() + static_cast<std::ptrdiff_t>(chunk_end(c)), scratch.begin() + static_cast<std::ptrdiff_t>(right_offset[c]));
+						}
+					});
+					pool.parallel_for(chunks, 1, [&](const std::size_t begin, const std::size_t end) {
+						std::copy(scratch.begin() + static_cast<std::ptrdiff_t>(chunk_begin(begin)), scratch.begin() + static_cast<std::ptrdiff_t>(chunk_end(end - 1)),
+							      data.begin() + static_cast<std::ptrdiff_t>(chunk_begin(begin)));
+					});
+
+					// subtrees
+					tree_type left_nodes;
+					ThreadPool::TaskGroup group;
+					pool.submit(group, [&]() {
+						left_nodes = this->build_parallel(data, scratch, left, mid, depth + 1, random.fork(0), extremes.left_min, extremes.left_max, pool, grain);
+					});
+					const tree_type right_nodes{ this->build_parallel(data, scratch, mid, right, depth + 1, random.fork(1), extremes.right_min, extremes.right_max, pool, grain) };
+					pool.wait(group);
+
+					// stitch subtrees
+					const size_type offset{ static_cast<size_type>(left_nodes.size()) };
+					nodes = std::move(left_nodes);
+					nodes.reserve(nodes.size() + right_nodes.size() + 1);
+					for (node_type node : right_nodes) {
+						node.left = (node.left >= 0) ? node.left + offset : node.left;
+						node.right = (node.right >= 0) ? node.right + offset : node.right;
+						nodes.push_back(node);
+					}
+					nodes.push_back(node_type{ .split_value = anchor, .left = offset - 1, .right = static_cast<size_type>(nodes.size() - 1) });
+
+					return nodes;
+				}
+		};
+		static_assert(Interface::ITree<ITree<INode<double>>, std::vector<double>::iterator>);
+
+		/**
+		* \brief Interface::ITree implementation which materializes its nodes on demand.
+		*        building the tree only expands its top 'expand_depth' levels, deeper subtrees are
+		*        kept as pending sample ranges and are expanded (thread safely) once a query reaches them.
+		*        every pending subtree keeps a copy of its own samples, released once it is expanded, and a
+		*        scratch buffer is only allocated (as large as the expanded range) while expanding.
+		*        this saves the nodes of subtrees no query reaches, but not the memory of their samples.
+		*        for a given seed, path lengths are identical to those of ITree.
+		**/
+		template<Interface::INode Node>
+		struct LazyITree {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+			using tree_type = std::vector<node_type>;
+
+			/**
+			* \brief construct LazyITree with predefined maximal depth
+			* @param {size_type, in} maximal depth
+			* @param {uint64_t,  in} random seed
+			* @param {size_type, in} amount of levels materialized at once
+			**/
+			explicit LazyITree(size_type _max_depth, std::uint64_t _seed = 0, size_type _expand_depth = 8) :
+				max_depth(_max_depth), expand_depth(std::max(_expand_depth, size_type{ 1 })), seed(_seed) {}
+
+			// LazyITree is regular (copies share their materialized nodes)
+			LazyITree(const LazyITree&) = default;
+			LazyITree(LazyITree&&) = default;
+			LazyITree& operator =(const LazyITree&) = delete;
+			LazyITree& operator =(LazyITree&&) = delete;
+			~LazyITree() = default;
+
+			/**
+			* \brief return root node id
+			* @param {size_t, out} tree root node id
+			**/
+			constexpr size_type root_id() const {
+				return static_cast<size_type>(this->root->tree.size() - 1);
+			};
+
+			/**
+			* \brief return amount of nodes materialized so far
+			* @param {size_t, out} amount of nodes
+			**/
+			std::size_t node_count() const {
+				return this->root ? LazyITree::node_count(*this->root) : 0;
+			}
+
+			/**
+			* \brief return amount of samples kept for expanding pending subtrees (0 once all are expanded)
+			* @param {size_t, out} amount of samples
+			**/
+			std::size_t sample_count() const {
+				return this->store ? this->store->samples.load(std::memory_order_relaxed) : 0;
+			}
+
+			/**
+			* \brief return lower bound of path lengths in tree, taken from its materialized top levels
+			* @param {value_type, out} lower bound of path length
+			**/
+			value_type min_path_length() const {
+				return this->shortest;
+			}
+
+			/**
+			* \brief return upper bound of path lengths in tree
+			* @param {value_type, out} upper bound of path length
+			**/
+			value_type max_path_length() const {
+				return static_cast<value_type>(this->max_depth - 1);
+			}
+
+			/**
+			* \brief build tree top levels from data given by range iterators to a given collection
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			void build(It first, It last) {
+				this->store = std::make_shared<Store>();
+				this->root = std::make_shared<Chunk>();
+				std::vector<value_type> samples(first, last);
+				const auto [min, max] = std::minmax_element(samples.begin(), samples.end());
+				this->expand(*this->root, samples, Range{ .left = 0, .right = static_cast<size_type>(samples.size()), .depth = 0, .random = Random{ this->seed },
+					                                      .min = samples.empty() ? value_type{} : *min, .max = samples.empty() ? value_type{} : *max });
+
+				// leaves and pending subtrees of top levels bound path lengths from below
+				const std::vector<size_type> depths{ node_depths(this->root->tree) };
+				size_type depth{ std::numeric_limits<size_type>::max() };
+				for (std::size_t i{}; i < depths.size(); ++i) {
+					depth = (this->root->tree[i].left < 0) ? std::min(depth, depths[i]) : depth;
+				}
+				this->shortest = static_cast<value_type>(depth - 1);
+			}
+
+			/**
+			* \brief return the path length of a given value, materializing pending subtrees on the way.
+			*        notice that this function is recursive.
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  node index
+			* @param {size_type,  in}  node depth
+			* @param {value_type, out} path length
+			**/
+			value_type path_length(const value_type& value, const size_type node_index, const size_type node_depth) const {
+				return this->walk(*this->root, value, node_index, node_depth);
+			};
+
+			// internals
+			private:
+				struct Chunk;
+
+				// samples range of a subtree
+				struct Range {
+					size_type left{};
+					size_type right{};
+					size_type depth{};
+					Random random{};
+					value_type min{};
+					value_type max{};
+				};
+
+				// subtree which was not materialized yet, marked in its chunk by a node whose right index is -(slot + 2)
+				struct Pending {
+					Range range;
+					std::vector<value_type> samples;    // samples of the subtree, released once it is expanded
+					std::once_flag once;
+					std::unique_ptr<Chunk> chunk;
+					std::atomic<const Chunk*> ready{ nullptr };
+				};
+
+				// eagerly built part of the tree
+				struct Chunk {
+					tree_type tree;
+					std::unique_ptr<Pending[]> pending;
+					std::size_t pending_count{};
+				};
+
+				// bookkeeping shared by copies of the tree
+				struct Store {
+					std::atomic<std::size_t> samples{};    // amount of samples kept by pending subtrees
+				};
+
+				// properties
+				std::shared_ptr<Store> store;
+				std::shared_ptr<Chunk> root;
+				const size_type max_depth;
+				const size_type expand_depth;
+				const std::uint64_t seed;
+				value_type shortest{};
+
+				/**
+				* \brief materialize 'expand_depth' levels of the subtree spanning samples[left, right),
+				*        copying the samples of every subtree left pending
+				**/
+				void expand(Chunk& chunk, std::vector<value_type>& samples, const Range& range) const {
+					std::vector<value_type> scratch(samples.size());
+					std::vector<Range> pending;
+					this->build_recursively(chunk, pending, samples, scratch, range.left, range.right, range.depth, range.depth + this->expand_depth, range.random, range.min, range.max);
+
+					chunk.pending_count = pending.size();
+					chunk.pending = std::make_unique<Pending[]>(pending.size());
+					std::size_t kept{};
+					for (std::size_t i{}; i < pending.size(); ++i) {
+						Pending& subtree{ chunk.pending[i] };
+						subtree.samples.assign(samples.begin() + pending[i].left, samples.begin() + pending[i].right);
+						subtree.range = pending[i];
+						subtree.range.left = 0;
+						subtree.range.right = static_cast<size_type>(subtree.samples.size());
+						kept += subtree.samples.size();
+					}
+					this->store->samples.fetch_add(kept, std::memory_order_relaxed);
+				}
+
+				/**
+				* \brief recursively build tree until given horizon depth
+				**/
+				size_type build_recursively(Chunk& chunk, std::vector<Range>& pending,
+					                        const std::span<value_type> samples, const std::span<value_type> scratch,
+					                        const size_type left, const size_type right,
+					                        const size_type depth, const size_type horizon, const Random random,
+					                        const value_type min, const value_type max) const {
+					if (right - left > 1 && depth < this->max_depth && depth >= horizon) {
+						chunk.tree.push_back(node_type{ .split_value = value_type{}, .left = -1, .right = -static_cast<size_type>(pending.size() + 2) });
+						pending.push_back(Range{ .left = left, .right = right, .depth = depth, .random = random, .min = min, .max = max });
+						return static_cast<size_type>(chunk.tree.size() - 1);
+					}
+
+					const Split<value_type, size_type> split{ (right - left <= 1 || depth >= this->max_depth) ?
+						                                      Split<value_type, size_type>{} :
+						                                      Implementation::split(samples, scratch, left, right, min, max, random) };
+
+					if (!split.valid) [[unlikely]] {
+						chunk.tree.push_back(node_type{});
+					}
+					else {
+						const node_type node{
+							.split_value = split.anchor,
+							.left = this->build_recursively(chunk, pending, samples, scratch, left, split.mid, depth + 1, horizon, random.fork(0), split.left_min, split.left_max),
+							.right = this->build_recursively(chunk, pending, samples, scratch, split.mid, right, depth + 1, horizon, random.fork(1), split.right_min, split.right_max)
+						};
+
+						chunk.tree.push_back(node);
+					}
+
+					// output
+					return static_cast<size_type>(chunk.tree.size() - 1);
+				}
+
+				/**
+				* \brief recursively walk a chunk, materializing the pending subtree the walk ends in
+				**/
+				value_type walk(const Chunk& chunk, const value_type& value, const size_type node_index, const size_type node_depth) const {
+					assert(node_index >= 0);
+					const node_type& node{ chunk.tree[static_cast<std::size_t>(node_index)] };
+
+					if (node.left >= 0 || node.right >= 0) [[likely]] {
+						if (value < node.split_value && node.left >= 0) {
+							return (this->walk(chunk, value, node.left, node_depth + 1));
+						}
+						else if (node.right >= 0) {
+							return (this->walk(chunk, value, node.right, node_depth + 1));
+						}
+					}
+					else if (node.right < -1) {
+						Pending& pending{ chunk.pending[static_cast<std::size_t>(-node.right - 2)] };
+						const Chunk* expanded{ pending.ready.load(std::memory_order_acquire) };
+						if (expanded == nullptr) [[unlikely]] {
+							std::call_once(pending.once, [this, &pending]() {
+								pending.chunk = std::make_unique<Chunk>();
+								this->expand(*pending.chunk, pending.samples, pending.range);
+								this->store->samples.fetch_sub(pending.samples.size(), std::memory_order_relaxed);
+								std::vector<value_type>().swap(pending.samples);
+								pending.ready.store(pending.chunk.get(), std::memory_order_release);
+							});
+							expanded = pending.chunk.get();
+						}
+
+						return (this->walk(*expanded, value, static_cast<size_type>(expanded->tree.size() - 1), node_depth));
+					}
+
+					return static_cast<value_type>(node_depth - 1);
+				}
+
+				/**
+				* \brief amount of nodes materialized in a chunk and its expanded pending subtrees
+				**/
+				static std::size_t node_count(const Chunk& chunk) {
+					std::size_t count{ chunk.tree.size() };
+					for (std::size_t i{}; i < chunk.pending_count; ++i) {
+						if (const Chunk* expanded{ chunk.pending[i].ready.load(std::memory_order_acquire) }; expanded != nullptr) {
+							count += LazyITree::node_count(*expanded);
+						}
+					}
+					return count;
+				}
+		};
+		static_assert(Interface::ITree<LazyITree<INode<double>>, std::vector<double>::iterator>);
+
+		/**
+		* \brief collection element and its "outlier" score
+		**/
+		template<typename T>
+		struct Outlier {
+			std::size_t index{};    // position in collection
+			T score{};              // "outlier" score
+		};
+
+		/**
+		* \brief Interface::IForest implementation
+		**/
+		template<Interface::INode Node, class Tree = ITree<Node>>
+		struct IForest {
+			using tree_type = Tree;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+
+			constexpr explicit IForest(const std::size_t num_trees, const size_type _max_depth, const std::uint64_t seed = 0) :
+				random{ seed }, max_depth{ _max_depth }, seeded{ num_trees }, sizes(num_trees) {
+				this->trees.reserve(num_trees);
+				for (std::size_t i{}; i < num_trees; ++i) {
+					this->trees.emplace_back(_max_depth, this->random.fork(i).state);
+				}
+				this->update_bounds();
+			}
+
+			// IForest is regular
+			IForest() = delete;
+			IForest(const IForest&) = default;
+			IForest(IForest&&) = default;
+			IForest& operator =(const IForest&) = default;
+			IForest& operator =(IForest&&) = default;
+			~IForest() = default;
+
+			/**
+			* \brief build forest from data given by range iterators to a given collection.
+			*        a threshold calibrated by a previous build is cleared (threshold() is infinity again).
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			constexpr void build(It first, It last) {
+				for (auto& tree : this->trees) {
+					tree.build(first, last);
+				}
+				std::fill(this->sizes.begin(), this->sizes.end(), static_cast<size_type>(std::distance(first, last)));
+				this->update_bounds();
+				this->contamination_threshold = std::numeric_limits<value_type>::infinity();
+			}
+
+			/**
+			* \brief build forest and calibrate the score threshold above which the given fraction of the
+			*        collection lies. training samples are scored from the leaves they land in while building,
+			*        so no additional scoring pass is needed. an empty collection clears the threshold.
+			*        throws std::invalid_argument (and forest is unchanged) if contamination is not in [0, 1].
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			* @param {value_type,       in} contamination, fraction of collection which is considered outlier
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>> &&
+				         requires(tree_type tree, It it, std::span<value_type> paths) { tree.build(it, it, paths); })
+			constexpr void build(It first, It last, const value_type contamination) {
+				if (!(contamination >= value_type{} && contamination <= value_type{ 1 })) [[unlikely]] {
+					throw std::invalid_argument("IsolationForest: contamination must be in [0, 1]");
+				}
+				const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+				std::vector<value_type> scores(count);
+				for (auto& tree : this->trees) {
+					tree.build(first, last, std::span<value_type>(scores));
+				}
+				std::fill(this->sizes.begin(), this->sizes.end(), static_cast<size_type>(count));
+				this->update_bounds();
+
+				// score of the k'th highest scoring sample
+				this->training_size = static_cast<size_type>(count);
+				for (auto& score : scores) {
+					score = Math::exp2(-(score / static_cast<value_type>(this->trees.size())) / this->calc_depth(this->training_size));
+				}
+				const std::size_t k{ std::clamp(static_cast<std::size_t>(std::ceil(contamination * static_cast<value_type>(count))), std::size_t{ 1 }, std::max(count, std::size_t{ 1 })) };
+				this->contamination_threshold = std::numeric_limits<value_type>::infinity();
+				if (count > 0) {
+					std::nth_element(scores.begin(), scores.begin() + static_cast<std::ptrdiff_t>(k - 1), scores.end(), std::greater<value_type>{});
+					this->contamination_threshold = scores[k - 1];
+				}
+			}
+
+			/**
+			* \brief build forest trees in parallel (clearing a calibrated threshold, see build)
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			* @param {ThreadPool,       in} pool executing tree builds
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			void build(It first, It last, ThreadPool& pool) {
+				pool.parallel_for(this->trees.size(), 1, [this, first, last, &pool](const std::size_t begin, const std::size_t end) {
+					for (std::size_t i{ begin }; i < end; ++i) {
+						if constexpr (requires { this->trees[i].build(first, last, pool); }) {
+							this->trees[i].build(first, last, pool);
+						}
+						else {
+							this->trees[i].build(first, last);
+						}
+					}
+				});
+				std::fill(this->sizes.begin(), this->sizes.end(), static_cast<size_type>(std::distance(first, last)));
+				this->update_bounds();
+				this->contamination_threshold = std::numeric_limits<value_type>::infinity();
+			}
+
+			/**
+			* \brief add trees built from data given by range iterators to a given collection, without rebuilding
+			*        existing trees. tree seeds continue the forest sequence, so a forest grown from n to n + k trees
+			*        on the same data is identical to a forest of n + k trees.
+			*        the collection may differ in size from the one existing trees were trained on, since every tree
+			*        keeps its own data size (see merge).
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			* @param {size_t,           in} amount of trees to add
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			constexpr void grow(It first, It last, const std::size_t count) {
+				const size_type size{ static_cast<size_type>(std::distance(first, last)) };
+				this->trees.reserve(this->trees.size() + count);
+				for (std::size_t i{}; i < count; ++i) {
+					this->trees.emplace_back(this->max_depth, this->random.fork(this->seeded++).state);
+					this->trees.back().build(first, last);
+					this->sizes.push_back(size);
+				}
+				this->update_bounds();
+			}
+
+			/**
+			* \brief build forest in batches of trees, until the score ranking of a held out sample stabilizes.
+			*        after every batch the sample is ranked by score, and building stops once the spearman rank
+			*        correlation with the ranking of the previous batch is at least 1 - tolerance.
+			*        existing trees (and a calibrated threshold) are discarded, and the forest equals a forest built
+			*        with the chosen amount of trees.
+			* @param {forward_iterator, in}  iterator for first element in collection
+			* @param {forward_iterator, in}  iterator for last element in collection
+			* @param {forward_iterator, in}  iterator for first element in held out sample
+			* @param {forward_iterator, in}  iterator for last element in held out sample
+			* @param {size_t,           in}  amount of trees added in every batch
+			* @param {value_type,       in}  tolerance of ranking change
+			* @param {size_t,           in}  maximal amount of trees
+			* @param {size_t,           out} amount of trees built
+			**/
+			template<std::forward_iterator It, std::forward_iterator SampleIt>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>> &&
+				         std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<SampleIt>())>>)
+			constexpr std::size_t build_adaptive(It first, It last, SampleIt sample_first, SampleIt sample_last,
+			                                     const std::size_t batch, const value_type tolerance, const std::size_t max_trees) {
+				this->trees.clear();
+				this->sizes.clear();
+				this->seeded = 0;
+				this->contamination_threshold = std::numeric_limits<value_type>::infinity();
+
+				const std::vector<value_type> sample(sample_first, sample_last);
+				const std::size_t n{ sample.size() };
+				std::vector<value_type> sums(n);
+				std::vector<std::size_t> order(n);
+				std::vector<std::size_t> ranks(n);
+				std::vector<std::size_t> previous(n);
+				while (this->trees.size() < max_trees) {
+					const std::size_t evaluated{ this->trees.size() };
+					this->grow(first, last, std::min(std::max(batch, std::size_t{ 1 }), max_trees - evaluated));
+
+					// rank sample by path length sum (i.e. by score), ties by position
+					for (std::size_t i{}; i < n; ++i) {
+						for (std::size_t t{ evaluated }; t < this->trees.size(); ++t) {
+							sums[i] += this->trees[t].path_length(sample[i], this->trees[t].root_id(), 0);
+						}
+						order[i] = i;
+					}
+					std::sort(order.begin(), order.end(), [&sums](const std::size_t a, const std::size_t b) {
+						return (sums[a] < sums[b]) || (sums[a] == sums[b] && a < b);
+					});
+					for (std::size_t r{}; r < n; ++r) {
+						ranks[order[r]] = r;
+					}
+
+					if (evaluated > 0 && n > 1) {
+						value_type squared{};
+						for (std::size_t i{}; i < n; ++i) {
+							const value_type d{ static_cast<value_type>(ranks[i]) - static_cast<value_type>(previous[i]) };
+							squared += d * d;
+						}
+						const value_type count{ static_cast<value_type>(n) };
+						const value_type correlation{ value_type{ 1 } - static_cast<value_type>(6.0) * squared / (count * (count * count - value_type{ 1 })) };
+						if (correlation >= value_type{ 1 } - tolerance) {
+							break;
+						}
+					}
+					std::swap(ranks, previous);
+				}
+
+				return this->trees.size();
+			}
+
+			/**
+			* \brief shrink forest to the subset of its trees which best preserves its scores on a validation sample.
+			*        trees are selected greedily, every step adding the tree which minimizes the squared deviation
+			*        of the subset scores from the full forest scores.
+			* @param {forward_iterator, in}  iterator for first element in validation sample
+			* @param {forward_iterator, in}  iterator for last element in validation sample
+			* @param {size_t,           in}  amount of trees to keep
+			* @param {size_type,        in}  data size
+			* @param {value_type,       out} maximal absolute score deviation over validation sample
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			constexpr value_type prune(It first, It last, const std::size_t count, const size_type size) {
+				const std::vector<value_type> sample(first, last);
+				const std::size_t n{ sample.size() };
+				const std::size_t total{ this->trees.size() };
+				const value_type depth{ this->calc_depth(size) };
+
+				// path length of every sample in every tree, and full forest scores
+				std::vector<value_type> paths(total * n);
+				std::vector<value_type> full(n);
+				for (std::size_t i{}; i < n; ++i) {
+					full[i] = this->score(sample[i], size);
+					for (std::size_t t{}; t < total; ++t) {
+						paths[t * n + i] = this->trees[t].path_length(sample[i], this->trees[t].root_id(), 0);
+					}
+				}
+
+				// greedy forward selection
+				std::vector<bool> selected(total);
+				std::vector<value_type> sums(n);
+				for (std::size_t k{}; k < std::min(count, total); ++k) {
+					std::size_t best{ total };
+					value_type best_error{ std::numeric_limits<value_type>::infinity() };
+					for (std::size_t t{}; t < total; ++t) {
+						if (selected[t]) {
+							continue;
+						}
+						value_type error{};
+						for (std::size_t i{}; i < n; ++i) {
+							const value_type deviation{ Math::exp2(-((sums[i] + paths[t * n + i]) / static_cast<value_type>(k + 1)) / depth) - full[i] };
+							error += deviation * deviation;
+						}
+						if (error < best_error) {
+							best = t;
+							best_error = error;
+						}
+					}
+					if (best == total) [[unlikely]] {
+						break;
+					}
+					selected[best] = true;
+					for (std::size_t i{}; i < n; ++i) {
+						sums[i] += paths[best * n + i];
+					}
+				}
+
+				// keep selected trees in their original order (trees are not assignable)
+				std::vector<tree_type> kept;
+				std::vector<size_type> kept_sizes;
+				for (std::size_t t{}; t < total; ++t) {
+					if (selected[t]) {
+						kept.push_back(std::move(this->trees[t]));
+						kept_sizes.push_back(this->sizes[t]);
+					}
+				}
+				this->trees = std::move(kept);
+				this->sizes = std::move(kept_sizes);
+				this->update_bounds();
+
+				value_type max_deviation{};
+				for (std::size_t i{}; i < n; ++i) {
+					max_deviation = std::max(max_deviation, std::abs(this->score(sample[i], size) - full[i]));
+				}
+				return max_deviation;
+			}
+
+			/**
+			* \brief insert a value into every tree (see ITree::insert).
+			*        the data size of every tree becomes the (decayed) amount of values it holds.
+			*        a threshold calibrated while building is kept as is, so it no longer marks the calibrated
+			*        contamination once values are inserted (rebuild to recalibrate it).
+			*        throws std::invalid_argument (and forest is unchanged) if decay is not in (0, 1].
+			* @param {value_type, in} value
+			* @param {value_type, in} leaf capacity
+			* @param {value_type, in} mass decay factor per insertion
+			**/
+			constexpr void insert(const value_type value, const value_type capacity, const value_type decay = value_type{ 1 })
+				requires(requires(tree_type tree) { tree.insert(value, capacity, decay); }) {
+				for (std::size_t i{}; i < this->trees.size(); ++i) {
+					this->trees[i].insert(value, capacity, decay);
+					this->sizes[i] = static_cast<size_type>(this->trees[i].mass() + static_cast<value_type>(0.5));
+				}
+				this->update_bounds();
+			}
+
+			/**
+			* \brief remove trees [first, last) from forest
+			* @param {size_t, in} index of first tree to remove
+			* @param {size_t, in} index after last tree to remove
+			**/
+			constexpr void drop(const std::size_t first, const std::size_t last) {
+				assert(first <= last && last <= this->trees.size());
+				// trees are not assignable, so kept trees are moved into a new vector
+				std::vector<tree_type> kept;
+				kept.reserve(this->trees.size() - (last - first));
+				for (std::size_t i{}; i < this->trees.size(); ++i) {
+					if (i < first || i >= last) {
+						kept.push_back(std::move(this->trees[i]));
+					}
+				}
+				this->trees = std::move(kept);
+				this->sizes.erase(this->sizes.begin() + static_cast<std::ptrdiff_t>(first), this->sizes.begin() + static_cast<std::ptrdiff_t>(last));
+				this->update_bounds();
+			}
+
+			/**
+			* \brief append the trees of another forest (e.g. trained on another shard of the data).
+			*        every tree keeps the data size it was trained on, and is normalized by it wherever no data size
+			*        is given (score(value), is_outlier(value), batch scoring and top_k without data size, and the
+			*        ensembles, registries and static forests made from the forest).
+			*        a threshold calibrated while building is kept as is.
+			* @param {IForest, in} trained forest (can be this forest)
+			**/
+			constexpr void merge(const IForest& other) {
+				// other may be this forest, so nothing is reallocated while it is read
+				const std::size_t count{ other.trees.size() };
+				this->trees.reserve(this->trees.size() + count);
+				this->sizes.reserve(this->sizes.size() + count);
+				for (std::size_t i{}; i < count; ++i) {
+					this->trees.push_back(other.trees[i]);
+					this->sizes.push_back(other.sizes[i]);
+				}
+				this->update_bounds();
+			}
+
+			// true if scoring can not throw (trees do not materialize nodes while scoring)
+			static constexpr bool nothrow_score{ noexcept(std::declval<const tree_type&>().path_length(value_type{}, size_type{}, size_type{})) };
+
+			/**
+			* \brief calculate given value "outlier" score.
+			*        with ITree trees, scoring does not allocate and visits at most trees * (max_depth + 1) nodes.
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  data size
+			* @param {value_type, out} outlier score
+			**/
+			constexpr value_type score(const value_type value, const size_type size) const noexcept(nothrow_score) {
+				value_type avg_path_len{};
+
+				for (const auto& tree : this->trees) {
+					avg_path_len += tree.path_length(value, tree.root_id(), 0);
+				}
+				avg_path_len /= static_cast<value_type>(this->trees.size());
+
+				return Math::exp2(-avg_path_len / this->calc_depth(size));
+			}
+
+			/**
+			* \brief calculate given value "outlier" score, normalizing every tree path length by the data size
+			*        it was trained on (i.e. 2^(-mean(h(x) / c(n)))), so trees trained on different amounts of data
+			*        (e.g. merged shards) can be mixed. identical to score(value, n) if all trees were trained on n values.
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
+			**/
+			constexpr value_type score(const value_type value) const noexcept(nothrow_score) {
+				value_type avg_path_len{};
+
+				for (std::size_t i{}; i < this->trees.size(); ++i) {
+					const tree_type& tree{ this->trees[i] };
+					avg_path_len += tree.path_length(value, tree.root_id(), 0) / this->tree_depths[i];
+				}
+				avg_path_len /= static_cast<value_type>(this->trees.size());
+
+				return Math::exp2(-avg_path_len / this->shared_depth);
+			}
+
+			/**
+			* \brief check if a value "outlier" score is at least a given threshold.
+			*        trees are evaluated one after the other, and evaluation stops as soon as the remaining trees
+			*        can not change the decision. with confidence below 1, evaluation also stops once the decision
+			*        holds with the given confidence (hoeffding bound over the trees evaluated so far).
+			* @param {value_type, in}  value
+			* @param {value_type, in}  score threshold
+			* @param {size_type,  in}  data size
+			* @param {value_type, in}  decision confidence, 1 for an exact decision
+			* @param {bool,       out} true if score(value, size) >= threshold
+			**/
+			constexpr bool is_outlier(const value_type value, const value_type threshold, const size_type size, const value_type confidence = value_type{ 1 }) const noexcept(nothrow_score) {
+				return this->decide<false>(value, threshold, size, confidence);
+			}
+
+			/**
+			* \brief check if a value is an outlier according to the threshold calibrated while building,
+			*        normalizing every tree by the data size it was trained on (see score(value))
+			* @param {value_type, in}  value
+			* @param {bool,       out} true if score(value) is at least the calibrated threshold
+			**/
+			constexpr bool is_outlier(const value_type value) const noexcept(nothrow_score) {
+				return this->decide<true>(value, this->contamination_threshold, size_type{}, value_type{ 1 });
+			}
+
+			/**
+			* \brief return score threshold calibrated while building (not updated by insert, merge or grow)
+			* @param {value_type, out} threshold
+			**/
+			constexpr value_type threshold() const {
+				return this->contamination_threshold;
+			}
+
+			/**
+			* \brief calculate "outlier" score of a collection of values in parallel
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {random_access_iterator, out} iterator for first score
+			* @param {size_type,              in}  data size
+			* @param {ThreadPool,             in}  pool executing score chunks
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out, const size_type size, ThreadPool& pool) const {
+				pool.parallel_for(static_cast<std::size_t>(std::distance(first, last)), batch_size, [this, first, out, size](const std::size_t begin, const std::size_t end) {
+					this->score_interleaved<false>(first + static_cast<std::ptrdiff_t>(begin), end - begin, out + static_cast<std::ptrdiff_t>(begin), size);
+				});
+			}
+
+			/**
+			* \brief calculate "outlier" score of a collection of values in parallel, normalizing every tree by the
+			*        data size it was trained on (identical to score(value) per value)
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {random_access_iterator, out} iterator for first score
+			* @param {ThreadPool,             in}  pool executing score chunks
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out, ThreadPool& pool) const {
+				pool.parallel_for(static_cast<std::size_t>(std::distance(first, last)), batch_size, [this, first, out](const std::size_t begin, const std::size_t end) {
+					this->score_interleaved<true>(first + static_cast<std::ptrdiff_t>(begin), end - begin, out + static_cast<std::ptrdiff_t>(begin), size_type{});
+				});
+			}
+
+			/**
+			* \brief calculate "outlier" score of a collection of values (identical to score(value, size) per value).
+			*        trees are walked for a batch of values at a time, with several walks interleaved: every step
+			*        advances each walk by one node and prefetches its next node, so the cache misses of independent
+			*        walks overlap instead of following each other.
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {random_access_iterator, out} iterator for first score
+			* @param {size_type,              in}  data size
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out, const size_type size) const {
+				const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+				for (std::size_t begin{}; begin < count; begin += batch_size) {
+					this->score_interleaved<false>(first + static_cast<std::ptrdiff_t>(begin), std::min(batch_size, count - begin), out + static_cast<std::ptrdiff_t>(begin), size);
+				}
+			}
+
+			/**
+			* \brief calculate "outlier" score of a collection of values, normalizing every tree by the data size it
+			*        was trained on (identical to score(value) per value)
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {random_access_iterator, out} iterator for first score
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out) const {
+				const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+				for (std::size_t begin{}; begin < count; begin += batch_size) {
+					this->score_interleaved<true>(first + static_cast<std::ptrdiff_t>(begin), std::min(batch_size, count - begin), out + static_cast<std::ptrdiff_t>(begin), size_type{});
+				}
+			}
+
+			/**
+			* \brief find the k highest scoring values of a collection in parallel, without storing all scores.
+			*        the collection is split in one part per worker, which keeps its k best values in a heap.
+			*        values are walked in batches, tree after tree with interleaved walks (see batch score), and
+			*        after every tree values are dropped as soon as their partial path length sum shows they can not
+			*        beat the worst value in any full heap.
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {size_t,                 in}  amount of values to return
+			* @param {size_type,              in}  data size
+			* @param {ThreadPool,             in}  pool executing score chunks
+			* @param {vector,                 out} values ordered by decreasing score (ties by increasing index)
+			**/
+			template<std::random_access_iterator It>
+			std::vector<Outlier<value_type>> top_k(It first, It last, const std::size_t k, const size_type size, ThreadPool& pool) const {
+				return this->select<false>(first, last, k, size, pool);
+			}
+
+			/**
+			* \brief find the k highest scoring values of a collection in parallel (see top_k above), normalizing
+			*        every tree by the data size it was trained on (scores identical to score(value))
+			* @param {random_access_iterator, in}  iterator for first value
+			* @param {random_access_iterator, in}  iterator for last value
+			* @param {size_t,                 in}  amount of values to return
+			* @param {ThreadPool,             in}  pool executing score chunks
+			* @param {vector,                 out} values ordered by decreasing score (ties by increasing index)
+			**/
+			template<std::random_access_iterator It>
+			std::vector<Outlier<value_type>> top_k(It first, It last, const std::size_t k, ThreadPool& pool) const {
+				return this->select<true>(first, last, k, size_type{}, pool);
+			}
+
+			/**
+			* \brief return amount of nodes in all trees
+			* @param {size_t, out} amount of nodes
+			**/
+			constexpr std::size_t node_count() const {
+				std::size_t count{};
+				for (const auto& tree : this->trees) {
+					count += tree.node_count();
+				}
+				return count;
+			}
+
+			/**
+			* \brief return forest trees
+			* @param {vector, out} trees
+			**/
+			constexpr const std::vector<tree_type>& forest() const {
+				return this->trees;
+			}
+
+			/**
+			* \brief return normalization of a tree path length by the data size the tree was trained on.
+			*        trees trained on one data size are normalized together (see normalization()), and this is 1.
+			* @param {size_t,     in}  tree index
+			* @param {value_type, out} divisor of tree path length
+			**/
+			constexpr value_type normalization(const std::size_t tree) const {
+				return this->tree_depths[tree];
+			}
+
+			/**
+			* \brief return normalization of the mean (normalized) path length of all trees, which is c(n) if all
+			*        trees were trained on n values, and 1 otherwise. score(value) is 2^(-mean / normalization()).
+			* @param {value_type, out} divisor of mean path length
+			**/
+			constexpr value_type normalization() const {
+				return this->shared_depth;
+			}
+
+			/**
+			* \brief estimated expected path length for given data size
+			* @param {size_type,  in}  data size
+			* @param {value_type, out} expected path length
+			**/
+			static constexpr value_type calc_depth(const size_type size) {
+				if (size <= 1) {
+					return value_type{};
+				}
+
+				return ((static_cast<value_type>(2.0) * (Math::log(static_cast<value_type>(size - 1)) + static_cast<value_type>(0.5772156649))) -
+					    (static_cast<value_type>(2.0) * (static_cast<value_type>(size - 1)) / static_cast<value_type>(size)));
+			}
+
+			// internals
+			private:
+				// properties
+				std::vector<tree_type> trees;
+				Random random;
+				size_type max_depth{};
+				std::size_t seeded{};         // amount of tree seeds drawn from random
+				std::vector<size_type> sizes;  // data size every tree was trained on
+				value_type min_path_sum{};    // sum of shortest path length of all trees
+				value_type max_path_sum{};    // sum of longest path length of all trees
+				bool uniform{ true };                // all trees were trained on one data size
+				std::vector<value_type> tree_depths;  // normalization of every tree path length (1 if uniform)
+				value_type shared_depth{};           // normalization of mean path length (1 if not uniform)
+				value_type min_normalized_sum{};     // sum of normalized shortest path length of all trees
+				value_type max_normalized_sum{};     // sum of normalized longest path length of all trees
+				value_type contamination_threshold{ std::numeric_limits<value_type>::infinity() };
+				size_type training_size{};
+
+				// amount of values scored together by batch scoring, and amount of interleaved walks
+				static constexpr std::size_t batch_size{ 1024 };
+				static constexpr std::size_t walks_count{ 16 };
+
+				/**
+				* \brief score up to batch_size values, interleaving tree walks.
+				*        path lengths are normalized by a given data size, or every tree by its own data size if TRAINED.
+				**/
+				template<bool TRAINED, std::random_access_iterator It, std::random_access_iterator Out>
+				void score_interleaved(It first, const std::size_t count, Out out, const size_type size) const {
+					if constexpr (!requires(const tree_type& tree) { tree.nodes().data(); }) {
+						for (std::size_t i{}; i < count; ++i) {
+							out[i] = TRAINED ? this->score(first[i]) : this->score(first[i], size);
+						}
+					}
+					else {
+						// path lengths are summed tree after tree, as score(value, size) and score(value) do
+						std::array<value_type, batch_size> sums{};
+						for (std::size_t t{}; t < this->trees.size(); ++t) {
+							this->walk_interleaved(this->trees[t], TRAINED ? this->tree_depths[t] : value_type{ 1 }, first,
+								                   [](const std::size_t i) { return i; }, count, sums.data());
+						}
+
+						const value_type depth{ TRAINED ? this->shared_depth : this->calc_depth(size) };
+						for (std::size_t i{}; i < count; ++i) {
+							out[i] = Math::exp2(-(sums[i] / static_cast<value_type>(this->trees.size())) / depth);
+						}
+					}
+				}
+
+				/**
+				* \brief add the path lengths in a tree (divided by unit) of values first[point(i)], i in [0, count), to
+				*        sums[point(i)]. walks are interleaved: every step advances each walk by one node and prefetches
+				*        its next node, so the cache misses of independent walks overlap instead of following each other.
+				**/
+				template<std::random_access_iterator It, class Point>
+				void walk_interleaved(const tree_type& tree, const value_type unit, It first, Point point, const std::size_t count, value_type* sums) const {
+					struct Walk {
+						std::size_t point{};
+						size_type index{};
+						size_type depth{};
+					};
+
+					const auto* nodes{ tree.nodes().data() };
+					const size_type root{ tree.root_id() };
+					std::array<Walk, walks_count> walks;
+					std::size_t active{};
+					std::size_t next{};
+					for (; active < walks_count && next < count; ++active, ++next) {
+						walks[active] = Walk{ .point = point(next), .index = root, .depth = 0 };
+					}
+
+					while (active > 0) {
+						for (std::size_t w{}; w < active;) {
+							Walk& walk{ walks[w] };
+							const auto& node{ nodes[static_cast<std::size_t>(walk.index)] };
+							const value_type value{ first[static_cast<std::ptrdiff_t>(walk.point)] };
+							const size_type child{ (value < node.split_value && node.left >= 0) ? node.left : node.right };
+							if (child >= 0) [[likely]] {
+								walk.index = child;
+								++walk.depth;
+								Simd::prefetch(nodes + child);
+								++w;
+								continue;
+							}
+
+							// leaf, start next value (or retire walk, the last walk takes its place)
+							sums[walk.point] += static_cast<value_type>(walk.depth - 1) / unit;
+							if (next < count) {
+								walk = Walk{ .point = point(next++), .index = root, .depth = 0 };
+								++w;
+							}
+							else {
+								walk = walks[--active];
+							}
+						}
+					}
+				}
+
+				/**
+				* \brief is_outlier, with path lengths normalized by a given data size, or every tree by its own data size if TRAINED
+				**/
+				template<bool TRAINED>
+				constexpr bool decide(const value_type value, const value_type threshold, const size_type size, const value_type confidence) const noexcept(nothrow_score) {
+					// score >= threshold <=> sum of (normalized) path lengths <= limit
+					const value_type depth{ TRAINED ? this->shared_depth : this->calc_depth(size) };
+					const value_type min_sum{ TRAINED ? this->min_normalized_sum : this->min_path_sum };
+					const value_type max_sum{ TRAINED ? this->max_normalized_sum : this->max_path_sum };
+					if (!(depth > value_type{}) || !(threshold > value_type{}) || !(max_sum < std::numeric_limits<value_type>::infinity())) [[unlikely]] {
+						return ((TRAINED ? this->score(value) : this->score(value, size)) >= threshold);
+					}
+					const value_type count{ static_cast<value_type>(this->trees.size()) };
+					const value_type limit{ -depth * Math::log(threshold) / Math::log(static_cast<value_type>(2.0)) * count };
+					const value_type range{ max_sum - min_sum };
+					const value_type log_risk{ (confidence < value_type{ 1 }) ? Math::log(static_cast<value_type>(2.0) / (value_type{ 1 } - confidence)) : value_type{} };
+					// (path lengths normalized tree by tree are not integral, so their sums round once per tree)
+					const value_type rounding{ (TRAINED && !this->uniform) ? count : value_type{ 1 } };
+					const value_type guard{ (std::abs(limit) + value_type{ 1 }) * std::numeric_limits<value_type>::epsilon() * static_cast<value_type>(16.0) * rounding };
+
+					value_type sum{};
+					value_type remaining_min{ min_sum };
+					value_type remaining_max{ max_sum };
+					for (std::size_t i{}; i < this->trees.size(); ++i) {
+						const tree_type& tree{ this->trees[i] };
+						const value_type unit{ TRAINED ? this->tree_depths[i] : value_type{ 1 } };
+						sum += tree.path_length(value, tree.root_id(), 0) / unit;
+						remaining_min -= tree.min_path_length() / unit;
+						remaining_max -= tree.max_path_length() / unit;
+
+						// decision is certain
+						if (sum + remaining_max < limit - guard) {
+							return true;
+						}
+						if (sum + remaining_min > limit + guard) {
+							return false;
+						}
+
+						// decision is statistically certain
+						if (log_risk > value_type{} && i + 1 < this->trees.size()) {
+							const value_type evaluated{ static_cast<value_type>(i + 1) };
+							const value_type mean{ sum / evaluated };
+							const value_type margin{ range / count * std::sqrt(log_risk / (static_cast<value_type>(2.0) * evaluated)) };
+							if (mean + margin < limit / count) {
+								return true;
+							}
+							if (mean - margin > limit / count) {
+								return false;
+							}
+						}
+					}
+
+					return (Math::exp2(-(sum / count) / depth) >= threshold);
+				}
+
+				/**
+				* \brief top_k, with path lengths normalized by a given data size, or every tree by its own data size if TRAINED
+				**/
+				template<bool TRAINED, std::random_access_iterator It>
+				std::vector<Outlier<value_type>> select(It first, It last, const std::size_t k, const size_type size, ThreadPool& pool) const {
+					const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+					if (k == 0 || count == 0) [[unlikely]] {
+						return {};
+					}
+
+					// heaps keep their worst value at front, one heap per worker (the collection is split in as many parts)
+					const auto better = [](const Outlier<value_type>& a, const Outlier<value_type>& b) {
+						return (a.score > b.score) || (a.score == b.score && a.index < b.index);
+					};
+					const std::size_t parts{ std::clamp(pool.size(), std::size_t{ 1 }, (count + batch_size - 1) / batch_size) };
+					const std::size_t part_size{ (count + parts - 1) / parts };
+					std::vector<std::vector<Outlier<value_type>>> heaps(parts);
+					std::atomic<value_type> bound{ value_type{} };
+					const value_type depth{ TRAINED ? this->shared_depth : this->calc_depth(size) };
+					const value_type min_sum{ TRAINED ? this->min_normalized_sum : this->min_path_sum };
+					const value_type trees_count{ static_cast<value_type>(this->trees.size()) };
+					const value_type rounding{ (TRAINED && !this->uniform) ? trees_count : value_type{ 1 } };
+
+					// lower bound of the path length sum of the trees after every tree
+					std::vector<value_type> remaining(this->trees.size());
+					value_type remaining_min{ min_sum };
+					for (std::size_t t{}; t < this->trees.size(); ++t) {
+						remaining_min -= this->trees[t].min_path_length() / (TRAINED ? this->tree_depths[t] : value_type{ 1 });
+						remaining[t] = remaining_min;
+					}
+
+					pool.parallel_for(count, part_size, [&](const std::size_t begin, const std::size_t end) {
+						std::vector<Outlier<value_type>>& heap{ heaps[begin / part_size] };
+						heap.reserve(std::min(k, end - begin));
+						std::array<value_type, batch_size> sums;
+						std::array<std::size_t, batch_size> alive;    // values of the batch which may still enter the result
+						for (std::size_t batch{ begin }; batch < end; batch += batch_size) {
+							std::size_t active{ std::min(batch_size, end - batch) };
+							for (std::size_t i{}; i < active; ++i) {
+								alive[i] = i;
+								sums[i] = value_type{};
+							}
+
+							const It values{ first + static_cast<std::ptrdiff_t>(batch) };
+							for (std::size_t t{}; t < this->trees.size() && active > 0; ++t) {
+								this->walk_interleaved(this->trees[t], TRAINED ? this->tree_depths[t] : value_type{ 1 }, values,
+									                   [&alive](const std::size_t i) { return alive[i]; }, active, sums.data());
+
+								// score below 'floor' can not enter the result, drop values whose partial sum shows it
+								const value_type floor{ std::max(bound.load(std::memory_order_relaxed), (heap.size() == k) ? heap.front().score : value_type{}) };
+								if (floor > value_type{} && depth > value_type{} && min_sum < std::numeric_limits<value_type>::infinity()) {
+									const value_type limit{ -depth * Math::log(floor) / Math::log(static_cast<value_type>(2.0)) * trees_count };
+									const value_type guard{ (std::abs(limit) + value_type{ 1 }) * std::numeric_limits<value_type>::epsilon() * static_cast<value_type>(16.0) * rounding };
+									std::size_t kept{};
+									for (std::size_t i{}; i < active; ++i) {
+										alive[kept] = alive[i];
+										kept += !(sums[alive[i]] + remaining[t] > limit + guard);
+									}
+									active = kept;
+								}
+							}
+
+							for (std::size_t i{}; i < active; ++i) {
+								const Outlier<value_type> candidate{ .index = batch + alive[i], .score = Math::exp2(-(sums[alive[i]] / trees_count) / depth) };
+								if (heap.size() < k) {
+									heap.push_back(candidate);
+									std::push_heap(heap.begin(), heap.end(), better);
+								}
+								else if (better(candidate, heap.front())) {
+									std::pop_heap(heap.begin(), heap.end(), better);
+									heap.back() = candidate;
+									std::push_heap(heap.begin(), heap.end(), better);
+								}
+							}
+
+							// a full heap bounds the k'th best score of the whole collection
+							if (heap.size() == k) {
+								value_type current{ bound.load(std::memory_order_relaxed) };
+								while (heap.front().score > current && !bound.compare_exchange_weak(current, heap.front().score, std::memory_order_relaxed)) {}
+							}
+						}
+					});
+
+					// merge heaps
+					std::vector<Outlier<value_type>> outliers;
+					for (const auto& heap : heaps) {
+						outliers.insert(outliers.end(), heap.begin(), heap.end());
+					}
+					const std::size_t amount{ std::min(k, outliers.size()) };
+					std::partial_sort(outliers.begin(), outliers.begin() + static_cast<std::ptrdiff_t>(amount), outliers.end(), better);
+					outliers.resize(amount);
+					return outliers;
+				}
+
+				/**
+				* \brief update sums of path length bounds and normalization of trees
+				**/
+				constexpr void update_bounds() {
+					this->min_path_sum = value_type{};
+					this->max_path_sum = value_type{};
+					for (const auto& tree : this->trees) {
+						this->min_path_sum += tree.min_path_length();
+						this->max_path_sum += tree.max_path_length();
+					}
+
+					// trees of one data size are normalized together, as score(value, size) does, other trees one by one
+					this->uniform = std::all_of(this->sizes.begin(), this->sizes.end(), [this](const size_type size) { return size == this->sizes.front(); });
+					this->shared_depth = this->uniform ? this->calc_depth(this->sizes.empty() ? size_type{} : this->sizes.front()) : value_type{ 1 };
+					this->tree_depths.resize(this->sizes.size());
+					this->min_normalized_sum = value_type{};
+					this->max_normalized_sum = value_type{};
+					for (std::size_t i{}; i < this->trees.size(); ++i) {
+						this->tree_depths[i] = this->uniform ? value_type{ 1 } : this->calc_depth(this->sizes[i]);
+						this->min_normalized_sum += this->trees[i].min_path_length() / this->tree_depths[i];
+						this->max_normalized_sum += this->trees[i].max_path_length() / this->tree_depths[i];
+					}
+				}
+		};
+		static_assert(Interface::IForest<IForest<INode<double>>, std::vector<double>::iterator>);
+		static_assert(Interface::IForest<IForest<INode<double>, LazyITree<INode<double>>>, std::vector<double>::iterator>);
+
+		/**
+		* \brief robust random cut tree over a dynamic set of points.
+		*        every node keeps the bounding range and amount of the points below it, nodes live in a pool
+		*        which reuses released nodes, and points are inserted and removed in O(depth).
+		*        a value goes left at a cut if it is not larger than the cut.
+		**/
+		template<typename T>
+			requires(std::is_floating_point_v<T>)
+		struct RCTree {
+			using value_type = T;
+			using size_type = std::int64_t;
+
+			/**
+			* \brief construct empty tree
+			* @param {uint64_t, in} random seed
+			**/
+			constexpr explicit RCTree(const std::uint64_t seed = 0) : random{ seed } {}
+
+			/**
+			* \brief return amount of points in tree
+			* @param {size_t, out} amount of points
+			**/
+			constexpr std::size_t size() const {
+				return (this->root >= 0) ? this->nodes[static_cast<std::size_t>(this->root)].mass : std::size_t{};
+			}
+
+			/**
+			* \brief return amount of nodes in use
+			* @param {size_t, out} amount of nodes
+			**/
+			constexpr std::size_t node_count() const {
+				return this->nodes.size() - this->released.size();
+			}
+
+			/**
+			* \brief insert a point.
+			*        walking down from the root, a cut is drawn uniformly in the range of the current subtree
+			*        extended by the point; if it separates the point from the subtree, the point becomes a sibling
+			*        of the subtree, otherwise the walk continues into the side of the point.
+			* @param {size_t,     in} point id (not in tree)
+			* @param {value_type, in} value
+			**/
+			constexpr void insert(const std::size_t id, const value_type value) {
+				if (this->leaf_of.size() <= id) {
+					this->leaf_of.resize(id + 1, -1);
+				}
+				assert(this->leaf_of[id] < 0);
+
+				if (this->root < 0) [[unlikely]] {
+					this->root = this->allocate(Node{ .min = value, .max = value, .mass = 1 });
+					this->leaf_of[id] = this->root;
+					return;
+				}
+
+				size_type index{ this->root };
+				while (true) {
+					Node& node{ this->nodes[static_cast<std::size_t>(index)] };
+					const value_type min{ std::min(node.min, value) };
+					const value_type max{ std::max(node.max, value) };
+
+					// duplicate of a leaf point
+					if (!(min < max)) {
+						++node.mass;
+						this->leaf_of[id] = index;
+						return;
+					}
+
+					const value_type cut{ draw_anchor(min, max, Random{ this->random.next() }) };
+					if (cut < node.min || cut >= node.max) {
+						const size_type parent{ node.parent };
+						const size_type leaf{ this->allocate(Node{ .min = value, .max = value, .parent = -1, .mass = 1 }) };
+						const bool left{ value <= cut };
+						const size_type split{ this->allocate(Node{ .cut = cut, .min = min, .max = max, .parent = parent,
+						                                            .left = left ? leaf : index, .right = left ? index : leaf,
+						                                            .mass = this->nodes[static_cast<std::size_t>(index)].mass + 1 }) };
+						this->nodes[static_cast<std::size_t>(leaf)].parent = split;
+						this->nodes[static_cast<std::size_t>(index)].parent = split;
+						this->replace_child(parent, index, split);
+						this->leaf_of[id] = leaf;
+						return;
+					}
+
+					node.min = min;
+					node.max = max;
+					++node.mass;
+					index = (value <= node.cut) ? node.left : node.right;
+				}
+			}
+
+			/**
+			* \brief remove a point. its leaf (unless it holds duplicates) and the leaf parent are released,
+			*        the leaf sibling takes the parent place, and ranges above it are narrowed.
+			* @param {size_t, in} point id (in tree)
+			**/
+			constexpr void erase(const std::size_t id) {
+				assert(id < this->leaf_of.size() && this->leaf_of[id] >= 0);
+				const size_type leaf{ this->leaf_of[id] };
+				this->leaf_of[id] = -1;
+
+				if (--this->nodes[static_cast<std::size_t>(leaf)].mass > 0) {
+					for (size_type index{ this->nodes[static_cast<std::size_t>(leaf)].parent }; index >= 0; index = this->nodes[static_cast<std::size_t>(index)].parent) {
+						--this->nodes[static_cast<std::size_t>(index)].mass;
+					}
+					return;
+				}
+
+				const size_type parent{ this->nodes[static_cast<std::size_t>(leaf)].parent };
+				this->release(leaf);
+				if (parent < 0) {
+					this->root = -1;
+					return;
+				}
+
+				const Node& removed{ this->nodes[static_cast<std::size_t>(parent)] };
+				const size_type sibling{ (removed.left == leaf) ? removed.right : removed.left };
+				const size_type grandparent{ removed.parent };
+				this->nodes[static_cast<std::size_t>(sibling)].parent = grandparent;
+				this->replace_child(grandparent, parent, sibling);
+				this->release(parent);
+
+				for (size_type index{ grandparent }; index >= 0; index = this->nodes[static_cast<std::size_t>(index)].parent) {
+					Node& node{ this->nodes[static_cast<std::size_t>(index)] };
+					const Node& left{ this->nodes[static_cast<std::size_t>(node.left)] };
+					const Node& right{ this->nodes[static_cast<std::size_t>(node.right)] };
+					node.min = std::min(left.min, right.min);
+					node.max = std::max(left.max, right.max);
+					--node.mass;
+				}
+			}
+
+			/**
+			* \brief collusive displacement of a point in tree, i.e. the largest ratio between the amount of points
+			*        in a sibling subtree and in the subtree holding the point, over all ancestors of the point
+			* @param {size_t,     in}  point id (in tree)
+			* @param {value_type, out} collusive displacement
+			**/
+			constexpr value_type codisp(const std::size_t id) const {
+				assert(id < this->leaf_of.size() && this->leaf_of[id] >= 0);
+				const size_type leaf{ this->leaf_of[id] };
+				return this->displacement(leaf, this->nodes[static_cast<std::size_t>(leaf)].mass);
+			}
+
+			/**
+			* \brief collusive displacement a value would have if it were inserted, the tree is left unchanged
+			* @param {value_type, in}  value
+			* @param {value_type, out} collusive displacement
+			**/
+			constexpr value_type codisp(const value_type value) const {
+				Random stream{ this->random };
+				size_type index{ this->root };
+				while (index >= 0) {
+					const Node& node{ this->nodes[static_cast<std::size_t>(index)] };
+					const value_type min{ std::min(node.min, value) };
+					const value_type max{ std::max(node.max, value) };
+					if (!(min < max)) {
+						return this->displacement(index, node.mass + 1);
+					}
+
+					const value_type cut{ draw_anchor(min, max, Random{ stream.next() }) };
+					if (cut < node.min || cut >= node.max) {
+						// value would be a leaf whose sibling is this subtree
+						return std::max(static_cast<value_type>(node.mass), this->displacement(index, node.mass + 1));
+					}
+					index = (value <= node.cut) ? node.left : node.right;
+				}
+				return value_type{};
+			}
+
+			// internals
+			private:
+				// node, a leaf holds a single value (min == max) which was inserted 'mass' times
+				struct Node {
+					value_type cut{};
+					value_type min{};
+					value_type max{};
+					size_type parent{ -1 };
+					size_type left{ -1 };
+					size_type right{ -1 };
+					std::size_t mass{};
+				};
+
+				// properties
+				std::vector<Node> nodes;
+				std::vector<size_type> released;    // pooled node indices
+				std::vector<size_type> leaf_of;     // leaf of every point id
+				size_type root{ -1 };
+				Random random;
+
+				/**
+				* \brief place a node in pool
+				**/
+				constexpr size_type allocate(const Node& node) {
+					if (!this->released.empty()) {
+						const size_type index{ this->released.back() };
+						this->released.pop_back();
+						this->nodes[static_cast<std::size_t>(index)] = node;
+						return index;
+					}
+					this->nodes.push_back(node);
+					return static_cast<size_type>(this->nodes.size() - 1);
+				}
+
+				/**
+				* \brief return a node to pool
+				**/
+				constexpr void release(const size_type index) {
+					this->released.push_back(index);
+				}
+
+				/**
+				* \brief point parent (or root) at a new child instead of an old one
+				**/
+				constexpr void replace_child(const size_type parent, const size_type old_child, const size_type new_child) {
+					if (parent < 0) {
+						this->root = new_child;
+						return;
+					}
+					Node& node{ this->nodes[static_cast<std::size_t>(parent)] };
+					(node.left == old_child ? node.left : node.right) = new_child;
+				}
+
+				/**
+				* \brief largest sibling to subtree mass ratio over the ancestors of a node, whose subtree holds 'mass' points
+				**/
+				constexpr value_type displacement(size_type index, std::size_t mass) const {
+					value_type result{};
+					for (size_type parent{ this->nodes[static_cast<std::size_t>(index)].parent }; parent >= 0;
+					     index = parent, parent = this->nodes[static_cast<std::size_t>(parent)].parent) {
+						const Node& node{ this->nodes[static_cast<std::size_t>(parent)] };
+						const size_type sibling{ (node.left == index) ? node.right : node.left };
+						result = std::max(result, static_cast<value_type>(this->nodes[static_cast<std::size_t>(sibling)].mass) / static_cast<value_type>(mass));
+						mass = node.mass + (mass - this->nodes[static_cast<std::size_t>(index)].mass);
+					}
+					return result;
+				}
+		};
+
+		/**
+		* \brief robust random cut forest, for sliding windows over streams.
+		*        points are given ids (ids of removed points are reused), and the "outlier" score is the
+		*        collusive displacement averaged over all trees.
+		**/
+		template<typename T>
+			requires(std::is_floating_point_v<T>)
+		struct RCForest {
+			using tree_type = RCTree<T>;
+			using value_type = T;
+
+			/**
+			* \brief construct forest
+			* @param {size_t,   in} amount of trees
+			* @param {uint64_t, in} random seed
+			**/
+			constexpr explicit RCForest(const std::size_t num_trees, const std::uint64_t seed = 0) {
+				const Random random{ seed };
+				this->trees.reserve(num_trees);
+				for (std::size_t i{}; i < num_trees; ++i) {
+					this->trees.emplace_back(random.fork(i).state);
+				}
+			}
+
+			/**
+			* \brief insert a point to every tree
+			* @param {value_type, in}  value
+			* @param {size_t,     out} point id
+			**/
+			constexpr std::size_t insert(const value_type value) {
+				std::size_t id{ this->next_id };
+				if (!this->free_ids.empty()) {
+					id = this->free_ids.back();
+					this->free_ids.pop_back();
+				}
+				else {
+					++this->next_id;
+				}
+
+				for (auto& tree : this->trees) {
+					tree.insert(id, value);
+				}
+				++this->points;
+				return id;
+			}
+
+			/**
+			* \brief remove a point from every tree
+			* @param {size_t, in} point id
+			**/
+			constexpr void erase(const std::size_t id) {
+				for (auto& tree : this->trees) {
+					tree.erase(id);
+				}
+				this->free_ids.push_back(id);
+				--this->points;
+			}
+
+			/**
+			* \brief return amount of points in forest
+			* @param {size_t, out} amount of points
+			**/
+			constexpr std::size_t size() const {
+				return this->points;
+			}
+
+			/**
+			* \brief calculate collusive displacement of a point in forest
+			* @param {size_t,     in}  point id
+			* @param {value_type, out} collusive displacement averaged over trees
+			**/
+			constexpr value_type codisp(const std::size_t id) const {
+				value_type sum{};
+				for (const auto& tree : this->trees) {
+					sum += tree.codisp(id);
+				}
+				return sum / static_cast<value_type>(this->trees.size());
+			}
+
+			/**
+			* \brief calculate given value "outlier" score, i.e. its collusive displacement had it been inserted
+			* @param {value_type, in}  value
+			* @param {value_type, out} collusive displacement averaged over trees
+			**/
+			constexpr value_type score(const value_type value) const {
+				value_type sum{};
+				for (const auto& tree : this->trees) {
+					sum += tree.codisp(value);
+				}
+				return sum / static_cast<value_type>(this->trees.size());
+			}
+
+			/**
+			* \brief return forest trees
+			* @param {vector, out} trees
+			**/
+			constexpr const std::vector<tree_type>& forest() const {
+				return this->trees;
+			}
+
+			// internals
+			private:
+				// properties
+				std::vector<tree_type> trees;
+				std::vector<std::size_t> free_ids;
+				std::size_t next_id{};
+				std::size_t points{};
+		};
+		static_assert(Interface::IStreamForest<RCForest<double>>);
+
+		/**
+		* \brief half-space trees for high rate streams.
+		*        every tree is a complete binary tree of fixed depth over a randomly shifted work range, whose nodes
+		*        halve the range of their parent, so the node a value passes at every depth follows from the leaf
+		*        index floor(2^depth * relative position) without comparisons. node masses of the reference window
+		*        and of the latest window are kept in two flat arrays which swap roles every 'window' insertions.
+		*        every mass is stamped with its window, so a swap only advances the window counter and stale masses
+		*        are reset on their next increment. increments are atomic, so insertions may run concurrently.
+		*        insertion and scoring are O(trees * depth) and do not allocate.
+		*        NaN has no place in a work range: it is not counted by build or insert, and scores 1.
+		**/
+		template<typename T>
+			requires(std::is_floating_point_v<T>)
+		struct HSForest {
+			using value_type = T;
+
+			/**
+			* \brief construct forest
+			* @param {size_t,    in} amount of trees
+			* @param {size_t,    in} tree depth (at most 30)
+			* @param {size_t,    in} amount of insertions in a window
+			* @param {uint64_t,  in} random seed
+			**/
+			explicit HSForest(const std::size_t num_trees, const std::size_t _depth, const std::size_t _window, const std::uint64_t seed = 0) :
+				depth{ std::min(_depth, std::size_t{ 30 }) }, nodes{ (std::size_t{ 2 } << this->depth) - 1 }, window{ std::max(_window, std::size_t{ 1 }) },
+				size_limit{ static_cast<std::uint32_t>(std::max(this->window / 10, std::size_t{ 1 })) }, random{ seed }, ranges(num_trees) {
+				for (auto& masses : this->windows) {
+					masses = std::vector<std::atomic<std::uint64_t>>(num_trees * this->nodes);
+				}
+				this->place(value_type{}, value_type{ 1 });
+			}
+
+			// HSForest is not copyable, share it by reference
+			HSForest(const HSForest&) = delete;
+			HSForest(HSForest&&) = delete;
+			HSForest& operator =(const HSForest&) = delete;
+			HSForest& operator =(HSForest&&) = delete;
+			~HSForest() = default;
+
+			/**
+			* \brief set work ranges from the extremes of a collection and use it as reference window (NaN is skipped)
+			* @param {forward_iterator, in} iterator for first element in collection
+			* @param {forward_iterator, in} iterator for last element in collection
+			**/
+			template<std::forward_iterator It>
+				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
+			void build(It first, It last) {
+				value_type min{ std::numeric_limits<value_type>::infinity() };
+				value_type max{ -std::numeric_limits<value_type>::infinity() };
+				for (It it{ first }; it != last; ++it) {
+					min = std::min(min, std::isnan(*it) ? min : *it);
+					max = std::max(max, std::isnan(*it) ? max : *it);
+				}
+				if (!(min <= max)) [[unlikely]] {
+					return;
+				}
+				this->place(min, max);
+				for (It it{ first }; it != last; ++it) {
+					if (!std::isnan(*it)) {
+						this->count(*it, 0);
+					}
+				}
+				this->inserted.store(this->window, std::memory_order_release);
+			}
+
+			/**
+			* \brief insert a value into the latest window (the reference window is replaced once it is full).
+			*        NaN is ignored, and does not count towards the window.
+			* @param {value_type, in} value
+			**/
+			void insert(const value_type value) noexcept {
+				if (std::isnan(value)) [[unlikely]] {
+					return;
+				}
+				this->count(value, this->inserted.fetch_add(1, std::memory_order_acq_rel) / this->window);
+			}
+
+			/**
+			* \brief calculate given value "outlier" score from the reference window masses.
+			*        in every tree, the value descends from the root until it reaches the first node whose reference mass
+			*        is below 'size limit' (or a leaf); the value mass is the reference mass of that node scaled by 2^depth.
+			*        the score is one minus the mass summed over trees, relative to its maximum, so sparse regions score close to 1.
+			*        NaN scores 1.
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
+			**/
+			value_type score(const value_type value) const noexcept {
+				if (std::isnan(value)) [[unlikely]] {
+					return value_type{ 1 };
+				}
+				const std::size_t latest{ this->inserted.load(std::memory_order_acquire) / this->window };
+				const std::size_t reference{ latest - 1 };
+				const std::uint64_t stamp{ Stamp::of(reference) };
+
+				value_type mass{};
+				for (std::size_t t{}; t < this->ranges.size(); ++t) {
+					const std::size_t leaf{ this->leaf(t, value) };
+					const std::atomic<std::uint64_t>* masses{ this->windows[reference & 1].data() + t * this->nodes };
+					for (std::size_t k{}; k <= this->depth; ++k) {
+						const std::uint64_t slot{ masses[(std::size_t{ 1 } << k) - 1 + (leaf >> (this->depth - k))].load(std::memory_order_relaxed) };
+						const std::uint32_t node_mass{ ((slot & Stamp::mask) == stamp) ? static_cast<std::uint32_t>(slot) : 0u };
+						if (node_mass < this->size_limit || k == this->depth) {
+							mass += static_cast<value_type>(node_mass) * static_cast<value_type>(std::size_t{ 1 } << k);
+							break;
+						}
+					}
+				}
+				const value_type maximal{ static_cast<value_type>(this->ranges.size()) * static_cast<value_type>(this->window) *
+					                      static_cast<value_type>(std::size_t{ 1 } << this->depth) };
+				return value_type{ 1 } - std::min(mass / maximal, value_type{ 1 });
+			}
+
+			// internals
+			private:
+				// work range of a tree
+				struct Range {
+					value_type min{};
+					value_type scale{};    // 2^depth / range width
+				};
+
+				// node masses hold the window they count in their upper 32 bits
+				struct Stamp {
+					static constexpr std::uint64_t mask{ 0xFFFFFFFF00000000ull };
+					static constexpr std::uint64_t of(const std::size_t window) {
+						return static_cast<std::uint64_t>(window) << 32;
+					}
+				};
+
+				// properties
+				const std::size_t depth;
+				const std::size_t nodes;              // nodes per tree
+				const std::size_t window;
+				const std::uint32_t size_limit;
+				const Random random;
+				std::vector<Range> ranges;
+				std::array<std::vector<std::atomic<std::uint64_t>>, 2> windows;    // masses of even and odd windows
+				std::atomic<std::size_t> inserted{ 1 };                              // insertions, offset by one window
+
+				/**
+				* \brief shift work range of every tree around a point drawn in [min, max], so it covers [min, max]
+				**/
+				void place(const value_type min, const value_type max) {
+					for (std::size_t t{}; t < this->ranges.size(); ++t) {
+						const value_type center{ draw_anchor(min, max, this->random.fork(t)) };
+						const value_type radius{ std::max(static_cast<value_type>(2.0) * std::max(center - min, max - center), std::numeric_limits<value_type>::min()) };
+						this->ranges[t] = Range{ .min = center - radius, .scale = static_cast<value_type>(std::size_t{ 1 } << this->depth) / (static_cast<value_type>(2.0) * radius) };
+					}
+					for (auto& masses : this->windows) {
+						for (auto& mass : masses) {
+							mass.store(Stamp::of(~std::size_t{}), std::memory_order_relaxed);
+						}
+					}
+					this->inserted.store(this->window, std::memory_order_release);
+				}
+
+				/**
+				* \brief index of the leaf (at maximal depth) a value (not NaN) reaches in a tree
+				**/
+				std::size_t leaf(const std::size_t tree, const value_type value) const noexcept {
+					const Range& range{ this->ranges[tree] };
+					const value_type position{ std::clamp((value - range.min) * range.scale, value_type{},
+						                                  static_cast<value_type>((std::size_t{ 1 } << this->depth) - 1)) };
+					return static_cast<std::size_t>(position);
+				}
+
+				/**
+				* \brief add a value to the masses of a window, at the nodes it passes in every tree
+				**/
+				void count(const value_type value, const std::size_t window_index) noexcept {
+					const std::uint64_t stamp{ Stamp::of(window_index) };
+					for (std::size_t t{}; t < this->ranges.size(); ++t) {
+						const std::size_t leaf{ this->leaf(t, value) };
+						std::atomic<std::uint64_t>* masses{ this->windows[window_index & 1].data() + t * this->nodes };
+						for (std::size_t k{}; k <= this->depth; ++k) {
+							std::atomic<std::uint64_t>& slot{ masses[(std::size_t{ 1 } << k) - 1 + (leaf >> (this->depth - k))] };
+							std::uint64_t current{ slot.load(std::memory_order_relaxed) };
+							while (!slot.compare_exchange_weak(current, ((current & Stamp::mask) == stamp) ? current + 1 : stamp + 1, std::memory_order_relaxed)) {}
+						}
+					}
+				}
+		};
+		static_assert(Interface::IStreamDetector<HSForest<double>>);
+
+		/**
+		* \brief handle to an immutable forest which can be replaced while other threads score with it.
+		*        readers pin the current forest (RCU style) and keep using it even if a newer forest is published
+		*        meanwhile. pinning never waits nor allocates: a reader increments a counter in a cache line of its
+		*        own (shared only with threads hashed to the same slot) and loads the forest pointer.
+		*        rebuilding happens outside of the handle; publication stores the new pointer and then waits for a
+		*        grace period - until the readers which may hold the previous forest unpin it - before freeing it,
+		*        so only publishers wait. counters are split by an epoch which is flipped while waiting, so
+		*        readers arriving meanwhile do not extend the grace period.
+		**/
+		template<class Forest>
+		struct ForestHandle {
+			using forest_type = Forest;
+			using size_type = typename Forest::size_type;
+			using value_type = typename Forest::value_type;
+			static constexpr std::size_t slot_count{ 64 };
+
+			/**
+			* \brief forest pinned by a reader, it is not freed before it is unpinned (destroyed)
+			**/
+			struct Pin {
+				// Pin is bound to its scope
+				Pin(const Pin&) = delete;
+				Pin(Pin&&) = delete;
+				Pin& operator =(const Pin&) = delete;
+				Pin& operator =(Pin&&) = delete;
+				~Pin() {
+					this->readers.fetch_sub(1, std::memory_order_release);
+				}
+
+				const Forest& operator *() const noexcept {
+					return *this->forest;
+				}
+				const Forest* operator ->() const noexcept {
+					return this->forest;
+				}
+
+				// internals
+				private:
+					friend ForestHandle;
+					Pin(std::atomic<std::uint64_t>& _readers, const Forest* _forest) noexcept : readers(_readers), forest(_forest) {}
+
+					std::atomic<std::uint64_t>& readers;
+					const Forest* forest;
+			};
+
+			/**
+			* \brief construct handle to a trained forest
+			* @param {Forest, in} trained forest
+			**/
+			explicit ForestHandle(Forest forest) : current(new Forest(std::move(forest))) {}
+
+			// ForestHandle is not copyable, share it by reference
+			ForestHandle(const ForestHandle&) = delete;
+			ForestHandle(ForestHandle&&) = delete;
+			ForestHandle& operator =(const ForestHandle&) = delete;
+			ForestHandle& operator =(ForestHandle&&) = delete;
+			~ForestHandle() {
+				delete this->current.load(std::memory_order_acquire);
+			}
+
+			/**
+			* \brief pin current forest, e.g. to score many values with one forest
+			* @param {Pin, out} current forest, valid as long as the pin exists
+			**/
+			Pin pin() const noexcept {
+				Slot& slot{ this->slots[ForestHandle::slot_index()] };
+				std::atomic<std::uint64_t>& readers{ slot.readers[this->epoch.load(std::memory_order_seq_cst)] };
+				readers.fetch_add(1, std::memory_order_seq_cst);
+				return Pin{ readers, this->current.load(std::memory_order_seq_cst) };
+			}
+
+			/**
+			* \brief replace current forest, readers which pinned the previous forest keep using it.
+			*        returns once the previous forest is freed.
+			* @param {Forest, in} trained forest
+			**/
+			void publish(Forest forest) {
+				const Forest* fresh{ new Forest(std::move(forest)) };
+				std::lock_guard<std::mutex> lock(this->publishing);
+				const Forest* previous{ this->current.exchange(fresh, std::memory_order_seq_cst) };
+
+				// grace period, readers which pinned previous forest counted under either epoch
+				for (std::size_t flip{}; flip < 2; ++flip) {
+					const std::size_t parity{ this->epoch.load(std::memory_order_relaxed) };
+					this->epoch.store(parity ^ 1, std::memory_order_seq_cst);
+					for (const Slot& slot : this->slots) {
+						while (slot.readers[parity].load(std::memory_order_acquire) > 0) {
+							std::this_thread::yield();
+						}
+					}
+				}
+				delete previous;
+			}
+
+			/**
+			* \brief calculate given value "outlier" score using current forest
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  data size
+			* @param {value_type, out} outlier score
+			**/
+			value_type score(const value_type value, const size_type size) const {
+				return this->pin()->score(value, size);
+			}
+
+			// internals
+			private:
+				// reader counters of both epochs, a cache line per slot
+				struct alignas(64) Slot {
+					std::array<std::atomic<std::uint64_t>, 2> readers{};
+				};
+
+				// properties
+				std::atomic<const Forest*> current;
+				std::atomic<std::size_t> epoch{};
+				mutable std::array<Slot, slot_count> slots{};
+				std::mutex publishing;
+
+				/**
+				* \brief slot of calling thread
+				**/
+				static std::size_t slot_index() noexcept {
+					static std::atomic<std::size_t> next{};
+					thread_local const std::size_t index{ next.fetch_add(1, std::memory_order_relaxed) % slot_count };
+					return index;
+				}
+		};
+
+		/**
+		* \brief immutable, fixed size copy of a trained forest.
+		*        all trees share one node array, so a StaticForest produced in constant evaluation
+		*        is a literal which can be stored in read only memory.
+		**/
+		template<Interface::INode Node, std::size_t NODES, std::size_t TREES>
+		struct StaticForest {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+
+			std::array<node_type, NODES> nodes{};
+			std::array<size_type, TREES> roots{};
+			std::array<value_type, TREES> tree_depths{};    // normalization of every tree (see IForest::normalization)
+			value_type shared_depth{};                      // normalization of mean path length
+
+			/**
+			* \brief calculate given value "outlier" score (identical to IForest::score(value, size))
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  data size
+			* @param {value_type, out} outlier score
+			**/
+			constexpr value_type score(const value_type value, const size_type size) const noexcept {
+				value_type avg_path_len{};
+
+				for (const size_type root : this->roots) {
+					avg_path_len += this->path_length(value, root);
+				}
+				avg_path_len /= static_cast<value_type>(TREES);
+
+				return Math::exp2(-avg_path_len / IForest<Node>::calc_depth(size));
+			}
+
+			/**
+			* \brief calculate given value "outlier" score, normalizing every tree by the data size it was trained on
+			*        (identical to IForest::score(value))
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
+			**/
+			constexpr value_type score(const value_type value) const noexcept {
+				value_type avg_path_len{};
+
+				for (std::size_t t{}; t < TREES; ++t) {
+					avg_path_len += this->path_length(value, this->roots[t]) / this->tree_depths[t];
+				}
+				avg_path_len /= static_cast<value_type>(TREES);
+
+				return Math::exp2(-avg_path_len / this->shared_depth);
+			}
+
+			/**
+			* \brief path length of a value in the tree of a root
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  root
+			* @param {value_type, out} path length
+			**/
+			constexpr value_type path_length(const value_type value, const size_type root) const noexcept {
+				size_type index{ root };
+				size_type depth{};
+				while (this->nodes[static_cast<std::size_t>(index)].left >= 0) {
+					const node_type& node{ this->nodes[static_cast<std::size_t>(index)] };
+					index = (value < node.split_value) ? node.left : node.right;
+					++depth;
+				}
+				return static_cast<value_type>(depth - 1);
+			}
+		};
+
+		/**
+		* \brief copy a trained forest into a StaticForest.
+		*        usable in constant evaluation, where NODES is given by IForest::node_count.
+		*        throws std::invalid_argument (fails to compile in constant evaluation) if the forest does not have
+		*        exactly TREES trees and NODES nodes.
+		* @param {IForest,      in}  trained forest with TREES trees and NODES nodes
+		* @param {StaticForest, out} frozen forest
+		**/
+		template<std::size_t NODES, std::size_t TREES, Interface::INode Node>
+		constexpr StaticForest<Node, NODES, TREES> freeze(const IForest<Node>& forest) {
+			if (forest.node_count() != NODES || forest.forest().size() != TREES) [[unlikely]] {
+				throw std::invalid_argument("IsolationForest: frozen forest size differs from forest");
+			}
+			StaticForest<Node, NODES, TREES> frozen;
+
+			std::size_t offset{};
+			for (std::size_t t{}; t < TREES; ++t) {
+				const auto& nodes{ forest.forest()[t].nodes() };
+				for (std::size_t i{}; i < nodes.size(); ++i) {
+					Node node{ nodes[i] };
+					node.left = (node.left >= 0) ? node.left + static_cast<typename Node::size_type>(offset) : node.left;
+					node.right = (node.right >= 0) ? node.right + static_cast<typename Node::size_type>(offset) : node.right;
+					frozen.nodes[offset + i] = node;
+				}
+				offset += nodes.size();
+				frozen.roots[t] = static_cast<typename Node::size_type>(offset - 1);
+				frozen.tree_depths[t] = forest.normalization(t);
+			}
+			frozen.shared_depth = forest.normalization();
+
+			return frozen;
+		}
+
+		/**
+		* \brief registry of many small forests (e.g. one per series) kept in one shared node arena.
+		*        every forest is a range of roots into the arena, so a forest costs its nodes and a few words
+		*        instead of a vector per tree. replaced forests leave garbage in the arena, which is compacted
+		*        once it outgrows the live nodes. scoring takes a shared lock, inserting takes an exclusive lock.
+		**/
+		template<Interface::INode Node>
+		struct ForestRegistry {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+			using key_type = std::uint64_t;
+			using forest_type = IForest<Node>;
+
+			ForestRegistry() = default;
+
+			// ForestRegistry is not copyable, share it by reference
+			ForestRegistry(const ForestRegistry&) = delete;
+			ForestRegistry(ForestRegistry&&) = delete;
+			ForestRegistry& operator =(const ForestRegistry&) = delete;
+			ForestRegistry& operator =(ForestRegistry&&) = delete;
+			~ForestRegistry() = default;
+
+			/**
+			* \brief add a trained forest, or replace the forest registered under the same key.
+			*        the forest is scored as IForest::score(value, size).
+			* @param {key_type,    in} key
+			* @param {forest_type, in} trained forest
+			* @param {size_type,   in} data size the forest was trained on
+			**/
+			void insert(const key_type key, const forest_type& forest, const size_type size) {
+				this->insert(key, forest, forest_type::calc_depth(size), false);
+			}
+
+			/**
+			* \brief add a trained forest, or replace the forest registered under the same key.
+			*        the forest is scored as IForest::score(value) (i.e. every tree is normalized by the data size it
+			*        was trained on).
+			* @param {key_type,    in} key
+			* @param {forest_type, in} trained forest
+			**/
+			void insert(const key_type key, const forest_type& forest) {
+				this->insert(key, forest, forest.normalization(), true);
+			}
+
+			/**
+			* \brief retrain the forest of a key on a pool, and replace it once trained.
+			*        the forest registered under the key (if any) is used until then.
+			* @param {key_type,   in} key
+			* @param {vector,     in} training data
+			* @param {size_t,     in} amount of trees
+			* @param {size_type,  in} maximal tree depth
+			* @param {uint64_t,   in} seed
+			* @param {ThreadPool, in} pool executing the training
+			* @param {TaskGroup,  in} group to wait on for training to end
+			**/
+			void retrain(const key_type key, std::vector<value_type> data, const std::size_t num_trees, const size_type max_depth, const std::uint64_t seed,
+			             ThreadPool& pool, ThreadPool::TaskGroup& group) {
+				pool.submit(group, [this, key, data = std::move(data), num_trees, max_depth, seed]() {
+					forest_type forest{ num_trees, max_depth, seed };
+					forest.build(data.begin(), data.end());
+					this->insert(key, forest, static_cast<size_type>(data.size()));
+				});
+			}
+
+			/**
+			* \brief remove the forest registered under a key
+			* @param {key_type, in}  key
+			* @param {bool,     out} true if a forest was registered under key
+			**/
+			bool erase(const key_type key) {
+				std::unique_lock lock(this->mutex);
+				const auto it{ this->index.find(key) };
+				if (it == this->index.end()) {
+					return false;
+				}
+
+				// move last entry into the erased one
+				const std::size_t slot{ it->second };
+				this->garbage += this->entries[slot].nodes;
+				this->index.erase(it);
+				if (slot + 1 != this->entries.size()) {
+					this->entries[slot] = this->entries.back();
+					this->index[this->entries[slot].key] = slot;
+				}
+				this->entries.pop_back();
+
+				if (this->garbage > this->nodes.size() / 2) [[unlikely]] {
+					this->compact();
+				}
+				return true;
+			}
+
+			/**
+			* \brief check if a forest is registered under a key
+			* @param {key_type, in}  key
+			* @param {bool,     out} true if a forest is registered under key
+			**/
+			bool contains(const key_type key) const {
+				std::shared_lock lock(this->mutex);
+				return this->index.contains(key);
+			}
+
+			/**
+			* \brief return amount of registered forests
+			* @param {size_t, out} amount of forests
+			**/
+			std::size_t size() const {
+				std::shared_lock lock(this->mutex);
+				return this->entries.size();
+			}
+
+			/**
+			* \brief return amount of nodes in the arena (live and garbage)
+			* @param {size_t, out} amount of nodes
+			**/
+			std::size_t node_count() const {
+				std::shared_lock lock(this->mutex);
+				return this->nodes.size();
+			}
+
+			/**
+			* \brief calculate given value "outlier" score using the forest of a key (identical to IForest::score)
+			*        throws std::out_of_range if key is not registered.
+			* @param {key_type,   in}  key
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
+			**/
+			value_type score(const key_type key, const value_type value) const {
+				std::shared_lock lock(this->mutex);
+				const auto it{ this->index.find(key) };
+				if (it == this->index.end()) [[unlikely]] {
+					throw std::out_of_range("IsolationForest: key is not registered");
+				}
+				return this->score(this->entries[it->second], value);
+			}
+
+			/**
+			* \brief calculate "outlier" score of a batch of (key, value) pairs.
+			*        pairs are evaluated grouped by forest, so every forest is fetched once per batch.
+			*        throws std::out_of_range (before scoring) if a key is not registered.
+			* @param {random_access_iterator, in}  iterator for first pair
+			* @param {random_access_iterator, in}  iterator for last pair
+			* @param {random_access_iterator, out} iterator for first score
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out) const {
+				std::shared_lock lock(this->mutex);
+				const std::vector<std::pair<std::size_t, std::size_t>> order{ this->group(first, last) };
+				for (const auto& [slot, i] : order) {
+					out[i] = this->score(this->entries[slot], first[i].second);
+				}
+			}
+
+			/**
+			* \brief calculate "outlier" score of a batch of (key, value) pairs in parallel.
+			*        the lock is not held while waiting on the pool, since the waiting thread may execute a queued
+			*        retrain (which locks exclusively); every chunk locks on its own, and finds its forests by key
+			*        since forests may move in between. throws std::out_of_range if a key is not registered
+			*        (also if it is erased while the batch is scored).
+			* @param {random_access_iterator, in}  iterator for first pair
+			* @param {random_access_iterator, in}  iterator for last pair
+			* @param {random_access_iterator, out} iterator for first score
+			* @param {ThreadPool,             in}  pool executing score chunks
+			**/
+			template<std::random_access_iterator It, std::random_access_iterator Out>
+			void score(It first, It last, Out out, ThreadPool& pool) const {
+				std::vector<std::pair<std::size_t, std::size_t>> order;
+				{
+					std::shared_lock lock(this->mutex);
+					order = this->group(first, last);
+				}
+				pool.parallel_for(order.size(), 1024, [this, &order, first, out](const std::size_t begin, const std::size_t end) {
+					std::shared_lock lock(this->mutex);
+					std::size_t slot{};
+					for (std::size_t j{ begin }; j < end; ++j) {
+						const std::size_t i{ order[j].second };
+						if (j == begin || !(first[i].first == first[order[j - 1].second].first)) {
+							const auto it{ this->index.find(first[i].first) };
+							if (it == this->index.end()) [[unlikely]] {
+								throw std::out_of_range("IsolationForest: key is not registered");
+							}
+							slot = it->second;
+						}
+						out[i] = this->score(this->entries[slot], first[i].second);
+					}
+				});
+			}
+
+			// internals
+			private:
+				// registered forest
+				struct Entry {
+					key_type key{};
+					std::size_t first_root{};    // index of first tree root in roots
+					std::size_t tree_count{};
+					std::size_t nodes{};         // amount of nodes in arena
+					value_type depth{};          // normalization of mean path length
+				};
+
+				// properties
+				std::vector<node_type> nodes;
+				std::vector<size_type> roots;
+				std::vector<value_type> tree_depths;    // normalization of every tree (parallel to roots)
+				std::vector<Entry> entries;
+				std::unordered_map<key_type, std::size_t> index;    // key to entry
+				std::size_t garbage{};                              // amount of nodes no longer referenced
+				mutable std::shared_mutex mutex;
+
+				/**
+				* \brief add or replace a forest, normalized tree by tree if trained is true
+				**/
+				void insert(const key_type key, const forest_type& forest, const value_type depth, const bool trained) {
+					std::unique_lock lock(this->mutex);
+					const Entry entry{ .key = key,
+					                   .first_root = this->roots.size(),
+					                   .tree_count = forest.forest().size(),
+					                   .nodes = forest.node_count(),
+					                   .depth = depth };
+					this->append(forest, trained);
 
-		/**
-		* \brief Interface::INode implementation
-		**/
-		template<typename T, typename I = std::int64_t>
-			requires(std::is_floating_point_v<T>)
-		struct INode {
-			using size_type = I;
-			using value_type = T;
+					if (const auto it{ this->index.find(key) }; it != this->index.end()) {
+						this->garbage += this->entries[it->second].nodes;
+						this->entries[it->second] = entry;
+					}
+					else {
+						this->index.emplace(key, this->entries.size());
+						this->entries.push_back(entry);
+					}
 
-			value_type split_value{};
-			size_type left{ -1 };
-			size_type right{ -1 };
+					if (this->garbage > this->nodes.size() / 2) [[unlikely]] {
+						this->compact();
+					}
+				}
+
+				/**
+				* \brief append forest trees to arena, normalized tree by tree if trained is true
+				**/
+				void append(const forest_type& forest, const bool trained) {
+					for (std::size_t t{}; t < forest.forest().size(); ++t) {
+						const size_type offset{ static_cast<size_type>(this->nodes.size()) };
+						for (node_type node : forest.forest()[t].nodes()) {
+							node.left = (node.left >= 0) ? node.left + offset : node.left;
+							node.right = (node.right >= 0) ? node.right + offset : node.right;
+							this->nodes.push_back(node);
+						}
+						this->roots.push_back(static_cast<size_type>(this->nodes.size() - 1));
+						this->tree_depths.push_back(trained ? forest.normalization(t) : value_type{ 1 });
+					}
+				}
+
+				/**
+				* \brief copy live trees to a new arena, entry by entry (trees are contiguous in post order)
+				**/
+				void compact() {
+					std::vector<node_type> live;
+					std::vector<size_type> live_roots;
+					std::vector<value_type> live_depths;
+					live.reserve(this->nodes.size() - this->garbage);
+					for (auto& entry : this->entries) {
+						if (entry.tree_count == 0) [[unlikely]] {
+							entry.first_root = live_roots.size();
+							continue;
+						}
+						const size_type last{ this->roots[entry.first_root + entry.tree_count - 1] };
+						const size_type first{ last + 1 - static_cast<size_type>(entry.nodes) };
+						const size_type offset{ static_cast<size_type>(live.size()) - first };
+						for (size_type i{ first }; i <= last; ++i) {
+							node_type node{ this->nodes[static_cast<std::size_t>(i)] };
+							node.left = (node.left >= 0) ? node.left + offset : node.left;
+							node.right = (node.right >= 0) ? node.right + offset : node.right;
+							live.push_back(node);
+						}
+
+						const std::size_t first_root{ live_roots.size() };
+						for (std::size_t t{}; t < entry.tree_count; ++t) {
+							live_roots.push_back(this->roots[entry.first_root + t] + offset);
+							live_depths.push_back(this->tree_depths[entry.first_root + t]);
+						}
+						entry.first_root = first_root;
+					}
+					this->nodes = std::move(live);
+					this->roots = std::move(live_roots);
+					this->tree_depths = std::move(live_depths);
+					this->garbage = 0;
+				}
+
+				/**
+				* \brief (entry, position) of a batch of (key, value) pairs, ordered by entry arena position
+				**/
+				template<std::random_access_iterator It>
+				std::vector<std::pair<std::size_t, std::size_t>> group(It first, It last) const {
+					std::vector<std::pair<std::size_t, std::size_t>> order;
+					order.reserve(static_cast<std::size_t>(std::distance(first, last)));
+					for (std::size_t i{}; first + static_cast<std::ptrdiff_t>(i) != last; ++i) {
+						const auto it{ this->index.find(first[i].first) };
+						if (it == this->index.end()) [[unlikely]] {
+							throw std::out_of_range("IsolationForest: key is not registered");
+						}
+						order.emplace_back(it->second, i);
+					}
+					std::sort(order.begin(), order.end(), [this](const auto& a, const auto& b) {
+						const std::size_t a_root{ this->entries[a.first].first_root };
+						const std::size_t b_root{ this->entries[b.first].first_root };
+						return (a_root < b_root) || (a_root == b_root && a.second < b.second);
+					});
+					return order;
+				}
+
+				/**
+				* \brief "outlier" score of a value using a registered forest
+				**/
+				value_type score(const Entry& entry, const value_type value) const {
+					value_type avg_path_len{};
+
+					for (std::size_t t{}; t < entry.tree_count; ++t) {
+						size_type index{ this->roots[entry.first_root + t] };
+						size_type depth{};
+						while (this->nodes[static_cast<std::size_t>(index)].left >= 0) {
+							const node_type& node{ this->nodes[static_cast<std::size_t>(index)] };
+							index = (value < node.split_value) ? node.left : node.right;
+							++depth;
+						}
+						avg_path_len += static_cast<value_type>(depth - 1) / this->tree_depths[entry.first_root + t];
+					}
+					avg_path_len /= static_cast<value_type>(entry.tree_count);
+
+					return Math::exp2(-avg_path_len / entry.depth);
+				}
 		};
-		static_assert(Interface::INode<INode<double>>);
 
 		/**
-		* \brief Interface::ITree implementation
+		* \brief several trained forests (e.g. detectors of different depth or training window) evaluated together.
+		*        trees of all forests share one node array and are walked in lockstep groups, so a value is loaded
+		*        once and the walks of independent trees overlap, and every forest normalization is computed once.
 		**/
 		template<Interface::INode Node>
-		struct ITree {
+		struct ForestEnsemble {
 			using node_type = Node;
 			using size_type = typename Node::size_type;
 			using value_type = typename Node::value_type;
-			using tree_type = std::vector<node_type>;
+			using forest_type = IForest<Node>;
+
+			// amount of trees walked in lockstep
+			static constexpr std::size_t lanes{ 8 };
 
 			/**
-			* \brief construct ITree with predefined maximal depth
-			* @param {size_type, in} maximal depth
+			* \brief add a trained forest to the ensemble, scored as IForest::score(value, size)
+			* @param {forest_type, in}  trained forest
+			* @param {size_type,   in}  data size the forest was trained on
+			* @param {size_t,      out} position of forest score in ensemble scores
 			**/
-			explicit ITree(size_type _max_depth) : max_depth(_max_depth) {
-				this->tree.reserve(static_cast<std::size_t>((_max_depth > 100) ? _max_depth * (_max_depth / 100) : _max_depth));
+			std::size_t add(const forest_type& forest, const size_type size) {
+				const std::size_t member{ this->append(forest, false) };
+				this->depths.push_back(forest_type::calc_depth(size));
+				return member;
 			}
 
-			// ITree is regular
-			ITree(const ITree&) = default;
-			ITree(ITree&&) = default;
-			ITree& operator =(const ITree&) = delete;
-			ITree& operator =(ITree&&) = delete;
-			~ITree() = default;
-
 			/**
-			* \brief return root node id
-			* @param {size_t, out} tree root node id
+			* \brief add a trained forest to the ensemble, scored as IForest::score(value) (i.e. every tree is
+			*        normalized by the data size it was trained on)
+			* @param {forest_type, in}  trained forest
+			* @param {size_t,      out} position of forest score in ensemble scores
 			**/
-			constexpr size_type root_id() const {
-				return static_cast<size_type>(this->tree.size() - 1);
-			};
+			std::size_t add(const forest_type& forest) {
+				const std::size_t member{ this->append(forest, true) };
+				this->depths.push_back(forest.normalization());
+				return member;
+			}
 
 			/**
-			* \brief build tree from data given by range iterators to a given collection
-			*        notice that this function is recursive.
-			* @param {forward_iterator, in} iterator for first element in collection
-			* @param {forward_iterator, in} iterator for last element in collection
+			* \brief return amount of forests in ensemble
+			* @param {size_t, out} amount of forests
 			**/
-			template<std::forward_iterator It>
-				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
-			constexpr void build(It first, It last) {
-				std::vector<value_type> data(first, last);
-				this->build_recursively(data, size_type{}, static_cast<size_type>(std::distance(first, last)), size_type{});
-			};
+			std::size_t size() const noexcept {
+				return this->depths.size();
+			}
 
 			/**
-			* \brief return the path length of a given value
-			*        notice that this function is recursive.
+			* \brief calculate given value "outlier" score of every forest (identical to IForest::score)
 			* @param {value_type, in}  value
-			* @param {size_type,  in}  node index
-			* @param {size_type,  in}  node depth
-			* @param {value_type, out} path length
+			* @param {span,       out} score of every forest, as large as the ensemble
 			**/
-			constexpr value_type path_length(const value_type& value, const size_type node_index, const size_type node_depth) const {
-				assert(node_index > 0);
-				const node_type& node{ this->tree[static_cast<std::size_t>(node_index)] };
+			void score(const value_type value, std::span<value_type> scores) const {
+				assert(scores.size() == this->depths.size());
+				std::fill(scores.begin(), scores.end(), value_type{});
 
-				if (node.left >= 0 || node.right >= 0) [[likely]] {
-					if (value < node.split_value && node.left >= 0) {
-						return (this->path_length(value, node.left, node_depth + 1));
+				// path lengths are added in tree order, as IForest::score does
+				for (std::size_t first{}; first < this->roots.size(); first += lanes) {
+					const std::size_t count{ std::min(lanes, this->roots.size() - first) };
+					std::array<size_type, lanes> index{};
+					std::array<size_type, lanes> depth{};
+					for (std::size_t l{}; l < count; ++l) {
+						index[l] = this->roots[first + l];
+					}
+
+					bool walking{ true };
+					while (walking) {
+						walking = false;
+						for (std::size_t l{}; l < count; ++l) {
+							const node_type& node{ this->nodes[static_cast<std::size_t>(index[l])] };
+							if (node.left >= 0) {
+								index[l] = (value < node.split_value) ? node.left : node.right;
+								++depth[l];
+								walking = true;
+							}
+						}
 					}
-					else if (node.right >= 0) {
-						return (this->path_length(value, node.right, node_depth + 1));
+
+					for (std::size_t l{}; l < count; ++l) {
+						scores[this->owners[first + l]] += static_cast<value_type>(depth[l] - 1) / this->tree_depths[first + l];
 					}
 				}
 
-				return static_cast<value_type>(node_depth - 1);
-			};
+				for (std::size_t m{}; m < scores.size(); ++m) {
+					scores[m] = Math::exp2(-(scores[m] / this->tree_counts[m]) / this->depths[m]);
+				}
+			}
+
+			/**
+			* \brief calculate given value "outlier" score of every forest (identical to IForest::score)
+			* @param {value_type, in}  value
+			* @param {vector,     out} score of every forest, in order of addition
+			**/
+			std::vector<value_type> score(const value_type value) const {
+				std::vector<value_type> scores(this->depths.size());
+				this->score(value, scores);
+				return scores;
+			}
 
 			// internals
 			private:
 				// properties
-				tree_type tree;
-				const size_type max_depth;
+				std::vector<node_type> nodes;
+				std::vector<size_type> roots;
+				std::vector<std::size_t> owners;        // forest of every tree
+				std::vector<value_type> tree_depths;    // normalization of every tree
+				std::vector<value_type> depths;         // normalization of every forest
+				std::vector<value_type> tree_counts;    // amount of trees of every forest
 
 				/**
-				* \brief recursively build tree
+				* \brief append forest trees to the node array, normalized tree by tree if trained is true
 				**/
-				constexpr size_type build_recursively(std::span<value_type> data,
-					                                  const size_type left, const size_type right,
-					                                  const size_type depth) {
-					using iter_t = std::span<value_type>::iterator;
+				std::size_t append(const forest_type& forest, const bool trained) {
+					const std::size_t member{ this->depths.size() };
+					for (std::size_t t{}; t < forest.forest().size(); ++t) {
+						const size_type offset{ static_cast<size_type>(this->nodes.size()) };
+						for (node_type node : forest.forest()[t].nodes()) {
+							node.left = (node.left >= 0) ? node.left + offset : node.left;
+							node.right = (node.right >= 0) ? node.right + offset : node.right;
+							this->nodes.push_back(node);
+						}
+						this->roots.push_back(static_cast<size_type>(this->nodes.size() - 1));
+						this->owners.push_back(member);
+						this->tree_depths.push_back(trained ? forest.normalization(t) : value_type{ 1 });
+					}
+					this->tree_counts.push_back(static_cast<value_type>(forest.forest().size()));
+					return member;
+				}
+		};
+
+		/**
+		* \brief QuickScorer evaluation of a trained forest.
+		*        instead of walking trees, the split values of a block of (up to 64) trees are kept sorted,
+		*        every split a value passes to the right clears the leaves of its left subtree from its tree
+		*        leaves bitmask, and the lowest bit left in a tree bitmask is the leaf the value exits in.
+		*        limited to trees with up to 64 leaves (i.e. shallow trees).
+		**/
+		template<Interface::INode Node>
+		struct QuickScorer {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+			using mask_type = std::uint64_t;
+			static constexpr std::size_t block_size{ 64 };
+
+			/**
+			* \brief construct QuickScorer from a trained forest.
+			*        throws std::invalid_argument if a tree has more than 64 leaves (see supports).
+			* @param {IForest, in} trained forest whose trees have up to 64 leaves
+			**/
+			explicit QuickScorer(const IForest<Node>& forest) {
+				if (!QuickScorer::supports(forest)) [[unlikely]] {
+					throw std::invalid_argument("IsolationForest: QuickScorer supports trees of up to 64 leaves");
+				}
+				const auto& trees{ forest.forest() };
+				this->tree_count = trees.size();
+				this->leaves.resize(trees.size() * 64);
 
-					if (left >= right || depth >= this->max_depth || right == 0) [[unlikely]] {
-						this->tree.push_back(node_type{});
+				for (std::size_t first{}; first < trees.size(); first += block_size) {
+					Block block;
+					for (std::size_t t{ first }; t < std::min(first + block_size, trees.size()); ++t) {
+						std::size_t leaf_index{};
+						this->collect(block, trees[t].nodes(), trees[t].root_id(), 0, t - first, t, leaf_index);
 					}
-					else {
-						const std::size_t anchor_index{ static_cast<std::size_t>(left + rand() % (right - left)) };
-						const value_type& anchor{ data[anchor_index] };
-						const iter_t anchor_iter{ std::partition(data.begin() + left, data.begin() + right,
-																[&anchor](const value_type& v) -> bool { return (v < anchor); }) };
-						const size_type mid{ static_cast<size_type>(std::distance(data.begin(), anchor_iter)) };
-						const node_type node{
-							.split_value = anchor,
-			                .left = this->build_recursively(data, left, mid, depth + 1),
-			                .right = this->build_recursively(data, mid, right, depth + 1)
-						};
 
-						this->tree.push_back(node);
+					// sort splits by value
+					std::vector<std::size_t> order(block.splits.size());
+					for (std::size_t i{}; i < order.size(); ++i) {
+						order[i] = i;
+					}
+					std::sort(order.begin(), order.end(), [&block](std::size_t a, std::size_t b) { return block.splits[a] < block.splits[b]; });
+					Block sorted;
+					for (const std::size_t i : order) {
+						sorted.splits.push_back(block.splits[i]);
+						sorted.trees.push_back(block.trees[i]);
+						sorted.masks.push_back(block.masks[i]);
 					}
+					this->blocks.push_back(std::move(sorted));
+				}
+			}
 
-					// output
-					return this->root_id();
+			/**
+			* \brief check if a forest can be evaluated by QuickScorer
+			* @param {IForest, in}  trained forest
+			* @param {bool,    out} true if all trees have up to 64 leaves
+			**/
+			static bool supports(const IForest<Node>& forest) {
+				return std::ranges::all_of(forest.forest(), [](const auto& tree) {
+					return std::ranges::count_if(tree.nodes(), [](const node_type& node) { return node.left < 0; }) <= 64;
+				});
+			}
+
+			/**
+			* \brief calculate given value "outlier" score (identical to IForest::score)
+			* @param {value_type, in}  value
+			* @param {size_type,  in}  data size
+			* @param {value_type, out} outlier score
+			**/
+			value_type score(const value_type value, const size_type size) const noexcept {
+				value_type avg_path_len{};
+
+				for (std::size_t b{}; b < this->blocks.size(); ++b) {
+					const Block& block{ this->blocks[b] };
+					std::array<mask_type, block_size> exits;
+					exits.fill(~mask_type{});
+
+					for (std::size_t i{}; i < block.splits.size() && !(value < block.splits[i]); ++i) {
+						exits[block.trees[i]] &= block.masks[i];
+					}
+
+					const std::size_t first{ b * block_size };
+					for (std::size_t t{}; t < std::min(block_size, this->tree_count - first); ++t) {
+						avg_path_len += this->leaves[(first + t) * 64 + static_cast<std::size_t>(std::countr_zero(exits[t]))];
+					}
+				}
+				avg_path_len /= static_cast<value_type>(this->tree_count);
+
+				return Math::exp2(-avg_path_len / IForest<Node>::calc_depth(size));
+			}
+
+			// internals
+			private:
+				// splits of a block of trees, sorted by split value
+				struct Block {
+					std::vector<value_type> splits;
+					std::vector<std::uint8_t> trees;
+					std::vector<mask_type> masks;
+				};
+
+				// properties
+				std::vector<Block> blocks;
+				std::vector<value_type> leaves;     // path length of every (tree, leaf)
+				std::size_t tree_count{};
+
+				/**
+				* \brief recursively number tree leaves from left to right and collect its splits.
+				*        returns the leaf index range covered by the subtree.
+				**/
+				std::pair<std::size_t, std::size_t> collect(Block& block, const std::vector<node_type>& nodes,
+					                                        const size_type node_index, const size_type node_depth,
+					                                        const std::size_t block_tree, const std::size_t tree,
+					                                        std::size_t& leaf_index) {
+					const node_type& node{ nodes[static_cast<std::size_t>(node_index)] };
+					if (node.left < 0) {
+						this->leaves[tree * 64 + leaf_index] = static_cast<value_type>(node_depth - 1);
+						++leaf_index;
+						return { leaf_index - 1, leaf_index };
+					}
+
+					const auto [first, last] = this->collect(block, nodes, node.left, node_depth + 1, block_tree, tree, leaf_index);
+					const auto right = this->collect(block, nodes, node.right, node_depth + 1, block_tree, tree, leaf_index);
+
+					// values which are not smaller than split can not exit at left subtree leaves
+					const mask_type left_leaves{ ((last - first == 64) ? ~mask_type{} : ((mask_type{ 1 } << (last - first)) - 1)) << first };
+					block.splits.push_back(node.split_value);
+					block.trees.push_back(static_cast<std::uint8_t>(block_tree));
+					block.masks.push_back(~left_leaves);
+
+					return { first, right.second };
 				}
 		};
-		static_assert(Interface::ITree<ITree<INode<double>>, std::vector<double>::iterator>);
 
 		/**
-		* \brief Interface::IForest implementation
+		* \brief frozen forest whose nodes collapse three levels of a binary tree into one cache line.
+		*        every wide node holds the (up to 7) split values of the top three levels of a subtree in order
+		*        (padded with infinity), so a value descends by counting the split values it is not smaller than -
+		*        one vector compare with the kernel of the instruction set in use (see Simd::rank) - instead of one
+		*        dependent load per level. this holds since an isolation tree is a search tree: split values of a
+		*        left subtree are smaller than the split value above it.
+		*        children are implicit: the wide nodes below a wide node are stored consecutively from a base index,
+		*        and the rest of the line marks which children are leaves and how deep below the node every child is,
+		*        so the wide node reached is the base plus the amount of wide children before the rank, and a leaf
+		*        ends the path with its depth. a path of depth d thus loads d / 3 + 1 lines (3 for depth 8).
+		*        (trees do not record the size of their leaves, so as in IForest::score there is no leaf size correction.)
 		**/
 		template<Interface::INode Node>
-		struct IForest {
-			using tree_type = ITree<Node>;
+		struct WideForest {
+			using node_type = Node;
 			using size_type = typename Node::size_type;
 			using value_type = typename Node::value_type;
+			static constexpr std::size_t levels{ 3 };
+			static constexpr std::size_t fanout{ std::size_t{ 1 } << levels };
 
-			constexpr explicit IForest(const std::size_t num_trees, const size_type max_depth) : trees(num_trees, tree_type{ max_depth }) {}
+			/**
+			* \brief construct WideForest from a trained forest
+			* @param {IForest,   in} trained forest
+			* @param {size_type, in} data size
+			**/
+			explicit WideForest(const IForest<Node>& forest, const size_type size) : normalization(IForest<Node>::calc_depth(size)) {
+				for (const auto& tree : forest.forest()) {
+					this->roots.push_back(static_cast<std::uint32_t>(this->nodes.size()));
+					this->nodes.emplace_back();
+					this->collapse(tree.nodes(), tree.root_id(), this->roots.back());
+				}
+			}
 
-			// IForest is regular
-			IForest() = delete;
-			IForest(const IForest&) = default;
-			IForest(IForest&&) = default;
-			IForest& operator =(const IForest&) = default;
-			IForest& operator =(IForest&&) = default;
-			~IForest() = default;
+			/**
+			* \brief return amount of wide nodes
+			* @param {size_t, out} amount of wide nodes
+			**/
+			std::size_t node_count() const noexcept {
+				return this->nodes.size();
+			}
 
 			/**
-			* \brief build forest from data given by range iterators to a given collection
-			* @param {forward_iterator, in} iterator for first element in collection
-			* @param {forward_iterator, in} iterator for last element in collection
+			* \brief calculate given value "outlier" score (IForest::score with the data size given at construction)
+			* @param {value_type, in}  value
+			* @param {value_type, out} outlier score
 			**/
-			template<std::forward_iterator It>
-				requires(std::is_same_v<value_type, typename std::decay_t<decltype(*std::declval<It>())>>)
-			constexpr void build(It first, It last) {
-				std::vector<value_type> data(first, last);
+			value_type score(const value_type value) const noexcept {
+				value_type avg_path_len{};
 
-				for (auto& tree : this->trees) {
-					this->shuffle(data);
-					tree.build(data.begin(), data.end());
+				for (const std::uint32_t root : this->roots) {
+					std::size_t index{ root };
+					size_type depth{};
+					for (;;) {
+						const WideNode& node{ this->nodes[index] };
+						const std::size_t child{ std::min(Simd::rank<fanout - 1>(node.thresholds.data(), value), std::size_t{ node.last }) };
+						depth += static_cast<size_type>((node.depths >> (2 * child)) & 3u);
+						if ((node.leaves >> child) & 1u) {
+							break;
+						}
+						index = node.base + WideForest::ones[~static_cast<unsigned>(node.leaves) & ((1u << child) - 1)];
+					}
+					avg_path_len += static_cast<value_type>(depth - 1);
+				}
+				avg_path_len /= static_cast<value_type>(this->roots.size());
+
+				return Math::exp2(-avg_path_len / this->normalization);
+			}
+
+			// internals
+			private:
+				// split values of a subtree in order, index of the first wide node below them,
+				// and for every child whether it is a leaf and its depth below the node (two bits each)
+				struct alignas(64) WideNode {
+					std::array<value_type, fanout - 1> thresholds;
+					std::uint32_t base{};
+					std::uint8_t leaves{};
+					std::uint8_t last{};       // index of last child, values passing the padding (infinity, nan) exit there
+					std::uint16_t depths{};
+				};
+				static_assert(sizeof(WideNode) == 64, "a wide node is a single cache line");
+
+				// amount of set bits of every byte (std::popcount is not a single instruction unless the build targets it)
+				static constexpr std::array<std::uint8_t, 256> ones{ []() {
+					std::array<std::uint8_t, 256> table{};
+					for (std::size_t i{}; i < table.size(); ++i) {
+						table[i] = static_cast<std::uint8_t>(std::popcount(i));
+					}
+					return table;
+				}() };
+
+				// properties
+				std::vector<WideNode> nodes;
+				std::vector<std::uint32_t> roots;
+				value_type normalization{};
+
+				/**
+				* \brief collapse the top levels of the subtree below a binary node into a given wide node,
+				*        and the subtrees below them into consecutive wide nodes appended after it
+				**/
+				void collapse(const std::vector<node_type>& tree, const size_type index, const std::size_t slot) {
+					std::vector<value_type> thresholds;
+					std::vector<std::pair<size_type, std::size_t>> below;     // (node, depth below collapsed node) of every child, in order
+					const auto gather = [&tree, &thresholds, &below](const auto& self, const size_type node_index, const std::size_t level) -> void {
+						const node_type& node{ tree[static_cast<std::size_t>(node_index)] };
+						if (node.left < 0 || level == levels) {
+							below.emplace_back(node_index, level);
+							return;
+						}
+						self(self, node.left, level + 1);
+						thresholds.push_back(node.split_value);
+						self(self, node.right, level + 1);
+					};
+					gather(gather, index, 0);
+					assert(std::is_sorted(thresholds.begin(), thresholds.end()));
+
+					WideNode node{};
+					node.thresholds.fill(std::numeric_limits<value_type>::infinity());
+					std::copy(thresholds.begin(), thresholds.end(), node.thresholds.begin());
+					node.base = static_cast<std::uint32_t>(this->nodes.size());
+					node.last = static_cast<std::uint8_t>(below.size() - 1);
+					std::vector<size_type> subtrees;
+					for (std::size_t i{}; i < below.size(); ++i) {
+						node.depths |= static_cast<std::uint16_t>(below[i].second << (2 * i));
+						if (tree[static_cast<std::size_t>(below[i].first)].left < 0) {
+							node.leaves |= static_cast<std::uint8_t>(1u << i);
+						}
+						else {
+							subtrees.push_back(below[i].first);
+						}
+					}
+					this->nodes[slot] = node;
+
+					this->nodes.resize(this->nodes.size() + subtrees.size());
+					for (std::size_t i{}; i < subtrees.size(); ++i) {
+						this->collapse(tree, subtrees[i], node.base + i);
+					}
+				}
+		};
+
+		/**
+		* \brief succinct encoding of a trained forest, for archived or memory constrained models.
+		*        the topology of every tree is a level order bitvector (a set bit per split node, a cleared bit per leaf),
+		*        so in a tree whose i'th bit is its k'th set bit the children of node i are nodes 2k+1 and 2k+2,
+		*        where k is found by a rank query (a counter per 64 bits and a popcount). split values are quantized
+		*        to 16 bits over the range of the forest split values and stored by rank, so a split node costs
+		*        about 2.2 bytes and a leaf a bit and a half instead of a node each.
+		*        split values are quantized to [1, 65535] and values below the range to 0, so values below every split
+		*        value pass all of them to the left. a value which is smaller than a split value but falls in its
+		*        quantization step (range / 65534) passes it to the right, otherwise scores are those of IForest::score.
+		**/
+		template<Interface::INode Node>
+		struct SuccinctForest {
+			using node_type = Node;
+			using size_type = typename Node::size_type;
+			using value_type = typename Node::value_type;
+			using key_type = std::uint16_t;
+
+			/**
+			* \brief construct SuccinctForest from a trained forest
+			* @param {IForest, in} trained forest
+			**/
+			explicit SuccinctForest(const IForest<Node>& forest) {
+				// quantization range
+				value_type lo{ std::numeric_limits<value_type>::infinity() };
+				value_type hi{ -std::numeric_limits<value_type>::infinity() };
+				for (const auto& tree : forest.forest()) {
+					for (const node_type& node : tree.nodes()) {
+						if (node.left >= 0) {
+							lo = std::min(lo, node.split_value);
+							hi = std::max(hi, node.split_value);
+						}
+					}
+				}
+				this->lo = lo;
+				this->hi = hi;
+				this->scale = (hi > lo) ? static_cast<value_type>(std::numeric_limits<key_type>::max() - 1) / (hi - lo) : value_type{};
+
+				// level order topology and split values of every tree
+				std::size_t position{};
+				std::deque<size_type> queue;
+				for (const auto& tree : forest.forest()) {
+					this->trees.push_back(Tree{ .offset = position, .rank = this->thresholds.size() });
+					const auto& nodes{ tree.nodes() };
+					queue.push_back(tree.root_id());
+					while (!queue.empty()) {
+						const node_type& node{ nodes[static_cast<std::size_t>(queue.front())] };
+						queue.pop_front();
+						if (position % 64 == 0) {
+							this->bits.push_back(0);
+							this->ranks.push_back(static_cast<std::uint32_t>(this->thresholds.size()));
+						}
+						if (node.left >= 0) {
+							assert(node.right >= 0);
+							this->bits.back() |= std::uint64_t{ 1 } << (position % 64);
+							this->thresholds.push_back(this->quantize(node.split_value));
+							queue.push_back(node.left);
+							queue.push_back(node.right);
+						}
+						++position;
+					}
 				}
 			}
 
 			/**
-			* \brief calculate given value "outlier" score
+			* \brief return amount of bytes used by the encoding
+			* @param {size_t, out} amount of bytes
+			**/
+			std::size_t byte_count() const noexcept {
+				return sizeof(SuccinctForest) + this->bits.size() * sizeof(std::uint64_t) + this->ranks.size() * sizeof(std::uint32_t) +
+				       this->thresholds.size() * sizeof(key_type) + this->trees.size() * sizeof(Tree);
+			}
+
+			/**
+			* \brief calculate given value "outlier" score (IForest::score, up to split value quantization)
 			* @param {value_type, in}  value
 			* @param {size_type,  in}  data size
 			* @param {value_type, out} outlier score
 			**/
-			constexpr value_type score(const value_type value, const size_type size) {
+			value_type score(const value_type value, const size_type size) const noexcept {
+				const key_type key{ this->quantize(value) };
 				value_type avg_path_len{};
 
-				for (const auto& tree : this->trees) {
-					avg_path_len += tree.path_length(value, tree.root_id(), 0);
+				for (const Tree& tree : this->trees) {
+					std::size_t position{ tree.offset };
+					size_type depth{};
+					while ((this->bits[position / 64] >> (position % 64)) & 1) {
+						const std::size_t split{ this->ranks[position / 64] +
+						                         static_cast<std::size_t>(std::popcount(this->bits[position / 64] & ((std::uint64_t{ 1 } << (position % 64)) - 1))) };
+						position = tree.offset + 2 * (split - tree.rank) + ((key < this->thresholds[split]) ? 1 : 2);
+						++depth;
+					}
+					avg_path_len += static_cast<value_type>(depth - 1);
 				}
 				avg_path_len /= static_cast<value_type>(this->trees.size());
 
-				return static_cast<value_type>(std::pow(static_cast<value_type>(2.0), avg_path_len / this->calc_depth(size)));
+				return Math::exp2(-avg_path_len / IForest<Node>::calc_depth(size));
 			}
 
 			// internals
 			private:
+				// first bit of a tree, and amount of set bits before it
+				struct Tree {
+					std::size_t offset{};
+					std::size_t rank{};
+				};
+
 				// properties
-				std::vector<tree_type> trees;
+				std::vector<std::uint64_t> bits;        // level order topology of all trees
+				std::vector<std::uint32_t> ranks;       // amount of set bits before every word of 'bits'
+				std::vector<key_type> thresholds;       // quantized split values, in order of set bits
+				std::vector<Tree> trees;
+				value_type lo{};
+				value_type hi{};
+				value_type scale{};
 
 				/**
-				* \brief estimated expected path length for given data size
+				* \brief quantize a value: 0 below the range of split values, [1, 65535] within it, 65535 above it (or nan)
 				**/
-				constexpr value_type calc_depth(const size_type size) const {
-					if (size <= 1) {
-						return value_type{};
+				key_type quantize(const value_type value) const noexcept {
+					if (!(value < this->hi)) {
+						return std::numeric_limits<key_type>::max();
 					}
-
-					return ((static_cast<value_type>(2.0) * (std::log(static_cast<value_type>(size - 1)) + static_cast<value_type>(0.5772156649))) -
-						    (static_cast<value_type>(2.0) * (static_cast<value_type>(size - 1)) / static_cast<value_type>(size)));
-				}
-
-				constexpr void shuffle(std::vector<value_type>& vec) const {
-					for (std::size_t i{ vec.size() - 1 }; i > 0; --i) {
-						std::iter_swap(vec.begin() + i, vec.begin() + static_cast<std::size_t>(rand()) % (i + 1));
+					if (value < this->lo) {
+						return key_type{};
 					}
+					return static_cast<key_type>(1 + static_cast<key_type>(std::min((value - this->lo) * this->scale, static_cast<value_type>(std::numeric_limits<key_type>::max() - 1))));
 				}
 		};
-		static_assert(Interface::IForest<IForest<INode<double>>, std::vector<double>::iterator>);
+
+		/**
+		* \brief emit a trained forest as standalone c++ source.
+		*        the emitted namespace holds the nodes of all trees in one constexpr array, the tree roots,
+		*        the normalization constant of the given data size and an allocation free 'score' function
+		*        which returns exactly what IForest::score returns for that data size.
+		* @param {IForest,     in}  trained forest
+		* @param {size_type,   in}  data size
+		* @param {string_view, in}  name of emitted namespace
+		* @param {string,      out} c++ source
+		**/
+		template<Interface::INode Node>
+		std::string to_source(const IForest<Node>& forest, const typename Node::size_type size, const std::string_view name) {
+			using value_type = typename Node::value_type;
+			const std::string_view value_name{ std::is_same_v<value_type, float> ? "float" : (std::is_same_v<value_type, double> ? "double" : "long double") };
+			const std::string_view value_suffix{ std::is_same_v<value_type, float> ? "f" : (std::is_same_v<value_type, double> ? "" : "l") };
+			const std::string_view index_name{ sizeof(typename Node::size_type) > sizeof(std::int32_t) ? "std::int64_t" : "std::int32_t" };
+
+			std::ostringstream source;
+			source << std::hexfloat;
+			source << "// generated by IsolationForest::Implementation::to_source, do not edit\n"
+				   << "#pragma once\n#include <cmath>\n#include <cstdint>\n\n"
+				   << "namespace " << name << " {\n"
+				   << "\tstruct Node {\n\t\t" << value_name << " split_value;\n\t\t" << index_name << " left;\n\t\t" << index_name << " right;\n\t};\n\n";
+
+			std::vector<std::size_t> roots;
+			source << "\tinline constexpr Node nodes[] = {\n";
+			std::size_t offset{};
+			for (const auto& tree : forest.forest()) {
+				for (const auto& node : tree.nodes()) {
+					const auto relocate = [offset](const typename Node::size_type index) {
+						return (index >= 0) ? static_cast<std::int64_t>(offset) + index : std::int64_t{ -1 };
+					};
+					source << "\t\t{ " << node.split_value << value_suffix << ", " << relocate(node.left) << ", " << relocate(node.right) << " },\n";
+				}
+				offset += tree.node_count();
+				roots.push_back(offset - 1);
+			}
+			source << "\t};\n\n\tinline constexpr " << index_name << " roots[] = {";
+			for (const std::size_t root : roots) {
+				source << ' ' << root << ',';
+			}
+			source << " };\n\n"
+				   << "\tinline constexpr " << value_name << " normalization{ " << forest.calc_depth(size) << value_suffix << " };\n\n"
+				   << "\tinline " << value_name << " score(const " << value_name << " value) noexcept {\n"
+				   << "\t\t" << value_name << " avg_path_len{};\n"
+				   << "\t\tfor (const " << index_name << " root : roots) {\n"
+				   << "\t\t\t" << index_name << " index{ root };\n"
+				   << "\t\t\t" << index_name << " depth{};\n"
+				   << "\t\t\twhile (nodes[index].left >= 0) {\n"
+				   << "\t\t\t\tindex = (value < nodes[index].split_value) ? nodes[index].left : nodes[index].right;\n"
+				   << "\t\t\t\t++depth;\n"
+				   << "\t\t\t}\n"
+				   << "\t\t\tavg_path_len += static_cast<" << value_name << ">(depth - 1);\n"
+				   << "\t\t}\n"
+				   << "\t\tavg_path_len /= static_cast<" << value_name << ">(" << roots.size() << ");\n\n"
+				   << "\t\treturn static_cast<" << value_name << ">(std::pow(static_cast<" << value_name << ">(2.0), -avg_path_len / normalization));\n"
+				   << "\t}\n"
+				   << "};\n";
+
+			return source.str();
+		}
 	};
 
 	// API
 	template<typename T>
 		requires(std::is_floating_point_v<T>)
 	using Forest = Implementation::IForest<Implementation::INode<T>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using LazyForest = Implementation::IForest<Implementation::INode<T>, Implementation::LazyITree<Implementation::INode<T>>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using Registry = Implementation::ForestRegistry<Implementation::INode<T>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using Ensemble = Implementation::ForestEnsemble<Implementation::INode<T>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using WideForest = Implementation::WideForest<Implementation::INode<T>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using SuccinctForest = Implementation::SuccinctForest<Implementation::INode<T>>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using RandomCutForest = Implementation::RCForest<T>;
+
+	template<typename T>
+		requires(std::is_floating_point_v<T>)
+	using HalfSpaceForest = Implementation::HSForest<T>;
 };
@@ -0,0 +1,240 @@
+#include "IsolationForest.hpp"
+#include <iostream>
+#include <chrono>
+#include <random>
+
+// time 'scorer' over all 'values', in nanoseconds per value
+template<class Scorer>
+double measure(const std::vector<double>& values, Scorer&& scorer) {
+    double sink{};
+    const auto start = std::chrono::steady_clock::now();
+    for (const double val : values) {
+        sink += scorer(val);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    if (sink < 0.0) {
+        std::cout << sink;
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / static_cast<double>(values.size());
+}
+
+int main() {
+    std::mt19937_64 generator{ 7 };
+    std::normal_distribution<double> distribution{ 0.0, 1.0 };
+    std::vector<double> data(1 << 16);
+    for (auto& val : data) {
+        val = distribution(generator);
+    }
+    std::vector<double> queries(1 << 16);
+    for (auto& val : queries) {
+        val = distribution(generator);
+    }
+
+    // QuickScorer against recursive tree walk
+    for (const std::int64_t depth : { 4, 6 }) {
+        IsolationForest::Forest<double> forest{ 256, depth, 1 };
+        forest.build(data.begin(), data.end());
+        const IsolationForest::Implementation::QuickScorer<IsolationForest::Implementation::INode<double>> quick_scorer{ forest };
+
+        const double walk_ns{ measure(queries, [&](const double val) { return forest.score(val, 256); }) };
+        const double quick_ns{ measure(queries, [&](const double val) { return quick_scorer.score(val, 256); }) };
+        std::cout << "256 trees, depth " << depth << ": ITree::path_length " << walk_ns << " ns/value, QuickScorer " << quick_ns << " ns/value\n";
+    }
+
+    // early exit threshold decision against full scoring
+    {
+        IsolationForest::Forest<double> forest{ 200, 16, 1 };
+        forest.build(data.begin(), data.begin() + 4096);
+        const double full_ns{ measure(queries, [&](const double val) { return static_cast<double>(forest.score(val, 4096) >= 0.6); }) };
+        const double exact_ns{ measure(queries, [&](const double val) { return static_cast<double>(forest.is_outlier(val, 0.6, 4096)); }) };
+        const double confident_ns{ measure(queries, [&](const double val) { return static_cast<double>(forest.is_outlier(val, 0.6, 4096, 0.99)); }) };
+        std::cout << "200 trees, threshold 0.6: score " << full_ns << " ns/value, is_outlier " << exact_ns
+                  << " ns/value, is_outlier (0.99 confidence) " << confident_ns << " ns/value\n";
+    }
+
+    // latency distribution of single score calls
+    {
+        IsolationForest::Forest<double> forest{ 100, 12, 1 };
+        forest.build(data.begin(), data.begin() + 4096);
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        double sink{};
+        for (const double val : queries) {
+            const auto start = std::chrono::steady_clock::now();
+            sink += forest.score(val, 4096);
+            latencies.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](const double p) { return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))]; };
+        std::cout << "100 trees, depth 12 score latency: p50 " << percentile(0.5) << " ns, p99 " << percentile(0.99) << " ns, p99.9 " << percentile(0.999)
+                  << " ns, max " << latencies.back() << " ns (bound: " << 100 * 13 << " node visits)" << (sink < 0.0 ? " " : "") << '\n';
+    }
+
+    // interleaved batch scoring against scoring value by value, on a forest larger than the caches
+    {
+        IsolationForest::Forest<double> forest{ 100, 14, 1 };
+        forest.build(data.begin(), data.begin() + 16384);
+
+        std::vector<double> scores(queries.size());
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i{}; i < queries.size(); ++i) {
+            scores[i] = forest.score(queries[i], 16384);
+        }
+        const double single_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+        std::vector<double> batch_scores(queries.size());
+        start = std::chrono::steady_clock::now();
+        forest.score(queries.begin(), queries.end(), batch_scores.begin(), 16384);
+        const double batch_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+        std::cout << "100 trees of 16384 values, " << queries.size() << " values: one by one " << single_ns / static_cast<double>(queries.size())
+                  << " ns/value, interleaved batch " << batch_ns / static_cast<double>(queries.size()) << " ns/value" << (batch_scores == scores ? "" : " (mismatch)") << '\n';
+    }
+
+    // wide nodes (several levels per cache line) against binary nodes
+    for (const int depth : { 8, 12 }) {
+        IsolationForest::Forest<double> forest{ 200, depth, 1 };
+        forest.build(data.begin(), data.begin() + 4096);
+        const IsolationForest::WideForest<double> wide_forest{ forest, 4096 };
+
+        const double tree_ns{ measure(queries, [&forest](const double val) { return forest.score(val, 4096); }) };
+        const double wide_ns{ measure(queries, [&wide_forest](const double val) { return wide_forest.score(val); }) };
+        std::cout << "200 trees, depth " << depth << ": binary nodes " << tree_ns << " ns/value, wide nodes " << wide_ns << " ns/value ("
+                  << forest.node_count() << " binary nodes, " << wide_forest.node_count() << " wide nodes)\n";
+    }
+
+    // succinct encoding footprint and scoring against nodes
+    {
+        IsolationForest::Forest<double> forest{ 200, 12, 1 };
+        forest.build(data.begin(), data.begin() + 4096);
+        const IsolationForest::SuccinctForest<double> succinct_forest{ forest };
+
+        const double tree_ns{ measure(queries, [&forest](const double val) { return forest.score(val, 4096); }) };
+        const double succinct_ns{ measure(queries, [&succinct_forest](const double val) { return succinct_forest.score(val, 4096); }) };
+        std::cout << "200 trees, depth 12: nodes " << forest.node_count() * sizeof(IsolationForest::Implementation::INode<double>) << " bytes, "
+                  << tree_ns << " ns/value, succinct " << succinct_forest.byte_count() << " bytes, " << succinct_ns << " ns/value\n";
+    }
+
+    // top-k extraction against scoring everything and sorting
+    {
+        IsolationForest::Forest<double> forest{ 200, 16, 1 };
+        forest.build(data.begin(), data.begin() + 4096);
+        IsolationForest::Implementation::ThreadPool pool;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<double> scores(queries.size());
+        forest.score(queries.begin(), queries.end(), scores.begin(), 4096, pool);
+        std::partial_sort(scores.begin(), scores.begin() + 10, scores.end(), std::greater<double>{});
+        const double sort_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+        start = std::chrono::steady_clock::now();
+        const auto strongest = forest.top_k(queries.begin(), queries.end(), 10, 4096, pool);
+        const double top_k_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+        std::cout << "200 trees, top 10 of " << queries.size() << " values: score and sort " << sort_ns / static_cast<double>(queries.size())
+                  << " ns/value, top_k " << top_k_ns / static_cast<double>(queries.size()) << " ns/value" << (strongest[0].score == scores[0] ? "" : " (mismatch)") << '\n';
+    }
+
+    // fused ensemble against scoring every forest on its own
+    {
+        std::vector<IsolationForest::Forest<double>> detectors;
+        IsolationForest::Ensemble<double> ensemble;
+        for (const std::int64_t depth : { 6, 8, 10, 12 }) {
+            detectors.emplace_back(100, depth, static_cast<std::uint64_t>(depth));
+            detectors.back().build(data.begin(), data.begin() + 4096);
+            ensemble.add(detectors.back(), 4096);
+        }
+        std::vector<double> scores(detectors.size());
+        const double separate_ns{ measure(queries, [&](const double val) {
+            double sum{};
+            for (const auto& detector : detectors) {
+                sum += detector.score(val, 4096);
+            }
+            return sum;
+        }) };
+        const double fused_ns{ measure(queries, [&](const double val) {
+            ensemble.score(val, scores);
+            return scores[0];
+        }) };
+        std::cout << "4 forests of 100 trees: separate IForest::score " << separate_ns << " ns/value, ForestEnsemble " << fused_ns << " ns/value\n";
+    }
+
+    // random cut forest sliding window update (insert newest, erase oldest) and score
+    {
+        IsolationForest::RandomCutForest<double> forest{ 100, 1 };
+        std::vector<std::size_t> window;
+        for (std::size_t i{}; i < 256; ++i) {
+            window.push_back(forest.insert(data[i]));
+        }
+        std::size_t oldest{};
+        const double update_ns{ measure(queries, [&](const double val) {
+            forest.erase(window[oldest]);
+            window[oldest] = forest.insert(val);
+            oldest = (oldest + 1) % window.size();
+            return 0.0;
+        }) };
+        const double score_ns{ measure(queries, [&](const double val) { return forest.score(val); }) };
+        std::cout << "100 cut trees, window 256: update " << update_ns << " ns/value, score " << score_ns << " ns/value\n";
+    }
+
+    // half-space trees update and score
+    {
+        IsolationForest::HalfSpaceForest<double> forest{ 25, 15, 256, 1 };
+        forest.build(data.begin(), data.begin() + 256);
+        const double update_ns{ measure(queries, [&](const double val) {
+            forest.insert(val);
+            return 0.0;
+        }) };
+        const double score_ns{ measure(queries, [&](const double val) { return forest.score(val); }) };
+        std::cout << "25 half-space trees, depth 15: update " << update_ns << " ns/value, score " << score_ns << " ns/value\n";
+    }
+
+    // partition kernel against std::partition, on random and sorted inputs
+    const auto partition_benchmark = [&]<typename T>(const char* type) {
+        std::vector<T> random_values(1 << 20);
+        for (auto& val : random_values) {
+            val = static_cast<T>(distribution(generator));
+        }
+        std::vector<T> sorted_values(random_values);
+        std::sort(sorted_values.begin(), sorted_values.end());
+
+        for (const auto& [name, input] : { std::pair{ "random", &random_values }, std::pair{ "sorted", &sorted_values } }) {
+            std::vector<T> values(*input);
+            std::vector<T> scratch(values.size());
+            constexpr std::size_t repetitions{ 20 };
+
+            auto start = std::chrono::steady_clock::now();
+            std::size_t mid{};
+            for (std::size_t r{}; r < repetitions; ++r) {
+                values = *input;
+                mid += static_cast<std::size_t>(std::distance(values.begin(), std::partition(values.begin(), values.end(), [](const T v) { return v < T{}; })));
+            }
+            const double std_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+
+            const double elements{ static_cast<double>(repetitions * values.size()) };
+            std::cout << "partition " << type << ' ' << name << ": std::partition " << std_ns / elements << " ns/element";
+
+            // every kernel the cpu supports, selected at run time
+            using IsolationForest::Implementation::Simd::Isa;
+            const Isa detected{ IsolationForest::Implementation::Simd::isa() };
+            for (const auto& [isa, isa_name] : { std::pair{ Isa::scalar, "scalar" }, std::pair{ Isa::avx2, "avx2" }, std::pair{ Isa::avx512, "avx512" } }) {
+                if (IsolationForest::Implementation::Simd::select(isa) != isa) {
+                    continue;
+                }
+                start = std::chrono::steady_clock::now();
+                for (std::size_t r{}; r < repetitions; ++r) {
+                    values = *input;
+                    mid += IsolationForest::Implementation::partition(std::span<T>(values), T{}, std::span<T>(scratch)).mid;
+                }
+                const double kernel_ns{ static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()) };
+                std::cout << ", " << isa_name << ((isa == Isa::scalar) ? " fallback (std::partition with extremes) " : " kernel (with extremes) ") << kernel_ns / elements << " ns/element";
+            }
+            IsolationForest::Implementation::Simd::select(detected);
+            std::cout << (mid == 0 ? " " : "") << '\n';
+        }
+    };
+    partition_benchmark.operator()<double>("double");
+    partition_benchmark.operator()<float>("float");
+
+    return 0;
+}
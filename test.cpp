@@ -1,6 +1,60 @@
 #include "IsolationForest.hpp"
+#include "test_generated_forest.hpp" // to_source() of Forest<double>{ 5, 8, 42 } built from the example data
 #include <iostream>
 #include <map>
+#include <thread>
+#include <assert.h>
+#include <array>
+#include <deque>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+
+// amount of allocations made through operator new, to check allocation free paths.
+// replacements are not inlined, so the compiler does not pair their malloc and free with new and delete.
+std::atomic<std::size_t> allocations{};
+
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory{ std::malloc(size == 0 ? 1 : size) }; memory != nullptr) {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// reference data of the compile time model
+constexpr std::array<double, 20> reference_data{ 1.2, 1.8, 0.99, 10.4, 2.0, 1.86, 0.899, 1.3, 0.901, 1.345,
+                                                 1.25, 1.9, 0.96, 1.48, 1.97, 1.867, 1.9, 1.48, 0.001, 1.45, };
+
+constexpr IsolationForest::Forest<double> reference_forest() {
+    IsolationForest::Forest<double> forest{ 10, 8, 42 };
+    forest.build(reference_data.begin(), reference_data.end());
+    return forest;
+}
+
+// compile time model merged from shards of different sizes
+constexpr IsolationForest::Forest<double> merged_reference_forest() {
+    IsolationForest::Forest<double> forest{ reference_forest() };
+    IsolationForest::Forest<double> shard{ 5, 8, 43 };
+    shard.build(reference_data.begin(), reference_data.begin() + 10);
+    forest.merge(shard);
+    return forest;
+}
 
 int main() {
     // data
@@ -22,5 +76,684 @@ int main() {
     const auto max_element_index = std::distance(outlier_score.begin(), max_element_iter);
     std::cout << "suspected outlier is " << data[max_element_index] << '\n';
 
+    // lazy forest scores as the eager forest, also when its subtrees are materialized concurrently
+    IsolationForest::LazyForest<double> lazy_forest{ 25, 100 };
+    lazy_forest.build(data.begin(), data.end());
+    std::vector<std::thread> lazy_threads;
+    for (std::size_t t{}; t < 4; ++t) {
+        lazy_threads.emplace_back([&]() {
+            for (const auto& val : data) {
+                assert(lazy_forest.score(val, data.size()) == outlier_score[static_cast<std::size_t>(&val - data.data())]);
+            }
+        });
+    }
+    for (auto& thread : lazy_threads) {
+        thread.join();
+    }
+
+    // lazy tree materializes only the subtrees its queries reach, and releases the samples of every subtree it expands
+    std::vector<double> wide(4096);
+    for (std::size_t i{}; i < wide.size(); ++i) {
+        wide[i] = static_cast<double>((i * 7919) % 4096);
+    }
+    IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> eager_tree{ 64, 7 };
+    IsolationForest::Implementation::LazyITree<IsolationForest::Implementation::INode<double>> lazy_tree{ 64, 7 };
+    eager_tree.build(wide.begin(), wide.end());
+    lazy_tree.build(wide.begin(), wide.end());
+    const std::size_t pending_samples{ lazy_tree.sample_count() };
+    assert(pending_samples > 0 && pending_samples <= wide.size());
+    for (const double val : { -5.0, 17.0, 5000.0 }) {
+        assert(lazy_tree.path_length(val, lazy_tree.root_id(), 0) == eager_tree.path_length(val, eager_tree.root_id(), 0));
+    }
+    std::cout << "lazy tree materialized " << lazy_tree.node_count() << " of " << eager_tree.node_count() << " nodes\n";
+    assert(lazy_tree.sample_count() < pending_samples);
+    for (const double val : wide) {
+        assert(lazy_tree.path_length(val, lazy_tree.root_id(), 0) == eager_tree.path_length(val, eager_tree.root_id(), 0));
+    }
+    assert(lazy_tree.sample_count() == 0);
+
+    // scores are 2^(-mean path length / c(n)), split values are drawn between the extremes of the samples they split,
+    // and ranges which can not be split (a single sample or equal samples) are leaves (so a leaf at the root scores above 1)
+    IsolationForest::Forest<double> single_tree_forest{ 1, 16, 5 };
+    single_tree_forest.build(data.begin(), data.end());
+    const auto& single_tree{ single_tree_forest.forest()[0] };
+    for (const double val : data) {
+        const double expected{ std::exp2(-single_tree.path_length(val, single_tree.root_id(), 0) / IsolationForest::Forest<double>::calc_depth(data.size())) };
+        assert(single_tree_forest.score(val, data.size()) == expected);
+    }
+    const double root_split{ single_tree.nodes()[static_cast<std::size_t>(single_tree.root_id())].split_value };
+    assert(root_split >= *std::min_element(data.begin(), data.end()) && root_split <= *std::max_element(data.begin(), data.end()));
+    IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> constant_tree{ 64, 3 };
+    const std::vector<double> constant_data(100, 3.0);
+    constant_tree.build(constant_data.begin(), constant_data.end());
+    assert(constant_tree.node_count() == 1);
+    IsolationForest::Forest<double> constant_forest{ 4, 16, 5 };
+    constant_forest.build(constant_data.begin(), constant_data.end());
+    assert(constant_forest.score(3.0, constant_data.size()) > 1.0);
+    const std::vector<double> pair_data{ 1.0, 2.0 };
+    constant_tree.build(pair_data.begin(), pair_data.end());
+    assert(constant_tree.node_count() == 3 && constant_tree.path_length(0.0, constant_tree.root_id(), 0) == 0.0 && constant_tree.path_length(5.0, constant_tree.root_id(), 0) == 0.0);
+    const double pair_split{ constant_tree.nodes()[static_cast<std::size_t>(constant_tree.root_id())].split_value };
+    assert(pair_split >= 1.0 && pair_split <= 2.0);
+
+    // generated scorer matches the forest it was generated from
+    IsolationForest::Forest<double> generated_forest{ 5, 8, 42 };
+    generated_forest.build(data.begin(), data.end());
+    for (const double val : { -1.0, 0.9, 1.5, 3.0, 10.4, 20.0 }) {
+        assert(GeneratedForest::score(val) == generated_forest.score(val, data.size()));
+    }
+    for (const auto& val : data) {
+        assert(GeneratedForest::score(val) == generated_forest.score(val, data.size()));
+    }
+
+    // model trained at compile time
+    constexpr auto compiled_forest = IsolationForest::Implementation::freeze<reference_forest().node_count(), 10>(reference_forest());
+    static_assert(compiled_forest.score(10.4, reference_data.size()) > compiled_forest.score(1.3, reference_data.size()));
+    static_assert(compiled_forest.score(10.4, reference_data.size()) > 0.8);
+    // (constant evaluated logarithm handles the special values as std::log does)
+    static_assert(IsolationForest::Implementation::Math::log(std::numeric_limits<double>::infinity()) == std::numeric_limits<double>::infinity());
+    static_assert(IsolationForest::Implementation::Math::log(0.0) == -std::numeric_limits<double>::infinity());
+    static_assert(IsolationForest::Implementation::Math::log(-1.0) != IsolationForest::Implementation::Math::log(-1.0));
+    static_assert(IsolationForest::Implementation::Math::log(std::numeric_limits<float>::quiet_NaN()) != IsolationForest::Implementation::Math::log(std::numeric_limits<float>::quiet_NaN()));
+    static_assert(IsolationForest::Implementation::Math::log(std::numeric_limits<float>::max()) > 88.0f);
+    IsolationForest::Forest<double> runtime_forest{ reference_forest() };
+    for (const auto& val : data) {
+        assert(compiled_forest.score(val, data.size()) == runtime_forest.score(val, data.size()));
+    }
+    constexpr auto compiled_merged_forest = IsolationForest::Implementation::freeze<merged_reference_forest().node_count(), 15>(merged_reference_forest());
+    IsolationForest::Forest<double> runtime_merged_forest{ merged_reference_forest() };
+    // (tree normalizations of the compiled forest come from the constant evaluated logarithm)
+    for (const auto& val : data) {
+        assert(std::abs(compiled_merged_forest.score(val) - runtime_merged_forest.score(val)) < 1e-12);
+    }
+
+    // QuickScorer evaluates shallow forests as the tree walk does
+    IsolationForest::Forest<double> shallow_forest{ 100, 6, 3 };
+    shallow_forest.build(wide.begin(), wide.end());
+    assert(IsolationForest::Implementation::QuickScorer<IsolationForest::Implementation::INode<double>>::supports(shallow_forest));
+    const IsolationForest::Implementation::QuickScorer<IsolationForest::Implementation::INode<double>> quick_scorer{ shallow_forest };
+    for (const double val : { -5.0, 0.0, 17.0, 17.5, 2048.0, 4095.0, 5000.0 }) {
+        assert(quick_scorer.score(val, wide.size()) == shallow_forest.score(val, wide.size()));
+    }
+    // (forests beyond its limits are refused at run time, as are frozen forests of the wrong size)
+    IsolationForest::Forest<double> bushy_forest{ 4, 12, 3 };
+    bushy_forest.build(wide.begin(), wide.end());
+    assert(!IsolationForest::Implementation::QuickScorer<IsolationForest::Implementation::INode<double>>::supports(bushy_forest));
+    bool refused{ false };
+    try {
+        const IsolationForest::Implementation::QuickScorer<IsolationForest::Implementation::INode<double>> bushy_scorer{ bushy_forest };
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    assert(refused);
+    refused = false;
+    try {
+        [[maybe_unused]] const auto misfrozen = IsolationForest::Implementation::freeze<16, 4>(bushy_forest);
+    } catch (const std::invalid_argument&) {
+        refused = true;
+    }
+    assert(refused);
+
+    // forest is replaced while other threads score with it
+    IsolationForest::Implementation::ForestHandle<IsolationForest::Forest<double>> handle{ forest };
+    std::atomic<bool> retraining{ true };
+    std::vector<std::thread> readers;
+    for (std::size_t t{}; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (retraining.load()) {
+                for (const auto& val : data) {
+                    const double score{ handle.score(val, data.size()) };
+                    assert(score > 0.0 && score <= 1.0);
+                }
+                const auto pinned{ handle.pin() };
+                for (const auto& val : data) {
+                    assert(pinned->score(val, data.size()) == (*pinned).score(val, data.size()));
+                }
+            }
+        });
+    }
+    for (std::uint64_t seed{ 1 }; seed <= 50; ++seed) {
+        IsolationForest::Forest<double> retrained{ 25, 100, seed };
+        retrained.build(data.begin(), data.end());
+        handle.publish(std::move(retrained));
+    }
+    retraining.store(false);
+    for (auto& thread : readers) {
+        thread.join();
+    }
+
+    // parallel build and batch scoring on a shared pool match serial build and scoring
+    IsolationForest::Implementation::ThreadPool pool{ 4 };
+    IsolationForest::Forest<double> parallel_forest{ 25, 100 };
+    parallel_forest.build(data.begin(), data.end(), pool);
+    std::vector<double> parallel_score(data.size());
+    parallel_forest.score(data.begin(), data.end(), parallel_score.begin(), data.size(), pool);
+    assert(parallel_score == outlier_score);
+
+    // an exception thrown by a task is rethrown once by the wait on its group, after the other tasks ran
+    IsolationForest::Implementation::ThreadPool::TaskGroup failing_group;
+    std::atomic<std::size_t> succeeded{};
+    for (std::size_t i{}; i < 64; ++i) {
+        pool.submit(failing_group, [&succeeded, i]() {
+            if (i % 16 == 13) {
+                throw std::runtime_error("task failed");
+            }
+            succeeded.fetch_add(1);
+        });
+    }
+    bool rethrown{ false };
+    try {
+        pool.wait(failing_group);
+    } catch (const std::runtime_error& error) {
+        rethrown = (std::string_view(error.what()) == "task failed");
+    }
+    assert(rethrown && succeeded.load() == 60);
+    pool.wait(failing_group);
+    rethrown = false;
+    try {
+        pool.parallel_for(100, 10, [](const std::size_t first, const std::size_t) {
+            if (first == 50) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    assert(rethrown);
+
+    // interleaved batch scoring matches scoring value by value, across several batches
+    std::vector<double> batch_values;
+    for (std::size_t i{}; i < 2500; ++i) {
+        batch_values.push_back(data[i % data.size()] + static_cast<double>(i % 7));
+    }
+    std::vector<double> batch_scores(batch_values.size());
+    std::vector<double> lazy_batch_scores(batch_values.size());
+    parallel_forest.score(batch_values.begin(), batch_values.end(), batch_scores.begin(), data.size());
+    lazy_forest.score(batch_values.begin(), batch_values.end(), lazy_batch_scores.begin(), data.size());
+    for (std::size_t i{}; i < batch_values.size(); ++i) {
+        assert(batch_scores[i] == parallel_forest.score(batch_values[i], data.size()));
+        assert(lazy_batch_scores[i] == lazy_forest.score(batch_values[i], data.size()));
+    }
+
+    // tree built with parallel partitions and subtree tasks matches serially built tree
+    IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> parallel_tree{ 64, 7 };
+    parallel_tree.build(wide.begin(), wide.end(), pool, 64);
+    assert(parallel_tree.node_count() == eager_tree.node_count());
+    for (const double val : wide) {
+        assert(parallel_tree.path_length(val, parallel_tree.root_id(), 0) == eager_tree.path_length(val, eager_tree.root_id(), 0));
+    }
+
+    // wide forests collapse several tree levels per node
+    IsolationForest::Forest<double> deep_forest{ 20, 12, 3 };
+    deep_forest.build(wide.begin(), wide.end());
+    const IsolationForest::WideForest<double> wide_double_forest{ deep_forest, static_cast<std::int64_t>(wide.size()) };
+    assert(wide_double_forest.node_count() < deep_forest.node_count() / 4);
+    const IsolationForest::WideForest<double> wide_constant_forest{ constant_forest, static_cast<std::int64_t>(constant_data.size()) };
+    assert(wide_constant_forest.node_count() == 4 && wide_constant_forest.score(3.0) == constant_forest.score(3.0, constant_data.size()));
+    std::vector<float> wide_floats(wide.begin(), wide.end());
+    IsolationForest::Forest<float> float_forest{ 20, 12, 3 };
+    float_forest.build(wide_floats.begin(), wide_floats.end());
+    const IsolationForest::WideForest<float> wide_float_forest{ float_forest, static_cast<std::int64_t>(wide.size()) };
+
+    // succinct forest is an order of magnitude smaller and scores as the forest, up to split value quantization
+    const IsolationForest::SuccinctForest<double> succinct_forest{ deep_forest };
+    assert(succinct_forest.byte_count() * 10 < deep_forest.node_count() * sizeof(IsolationForest::Implementation::INode<double>));
+    std::size_t succinct_agreements{};
+    for (const double val : wide) {
+        const double expected{ deep_forest.score(val + 0.5, wide.size()) };
+        assert(std::abs(succinct_forest.score(val + 0.5, wide.size()) - expected) < 0.01);
+        succinct_agreements += (succinct_forest.score(val + 0.5, wide.size()) == expected);
+    }
+    assert(succinct_agreements > wide.size() / 2);
+    double lowest_split{ std::numeric_limits<double>::infinity() };
+    for (const auto& tree : deep_forest.forest()) {
+        for (const auto& node : tree.nodes()) {
+            lowest_split = (node.left >= 0) ? std::min(lowest_split, node.split_value) : lowest_split;
+        }
+    }
+    for (const double val : { -5000.0, 5000.0, lowest_split, std::nextafter(lowest_split, -1.0), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() }) {
+        assert(succinct_forest.score(val, wide.size()) == deep_forest.score(val, wide.size()));
+    }
+    // (the lowest split isolates a single low value, so passing it to the right would lengthen the path)
+    std::vector<double> clustered{ 0.0 };
+    for (std::size_t i{}; i < 255; ++i) {
+        clustered.push_back(1000.0 + static_cast<double>(i));
+    }
+    IsolationForest::Forest<double> clustered_forest{ 50, 8, 9 };
+    clustered_forest.build(clustered.begin(), clustered.end());
+    const IsolationForest::SuccinctForest<double> succinct_clustered_forest{ clustered_forest };
+    for (const double val : { -1e9, -100.0, -1.0, 0.0 }) {
+        assert(succinct_clustered_forest.score(val, clustered.size()) == clustered_forest.score(val, clustered.size()));
+    }
+
+    // every instruction set the cpu supports, selected at run time, builds the same trees (also from data holding NaN) and scores wide forests as the tree walk does
+    using IsolationForest::Implementation::Simd::Isa;
+    const Isa detected_isa{ IsolationForest::Implementation::Simd::isa() };
+    std::vector<double> wide_with_nan(wide);
+    for (std::size_t i{ 1 }; i < wide_with_nan.size(); i += 97) {
+        wide_with_nan[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    IsolationForest::Implementation::Simd::select(Isa::scalar);
+    IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> scalar_nan_tree{ 64, 7 };
+    scalar_nan_tree.build(wide_with_nan.begin(), wide_with_nan.end());
+    // (partition reports the extremes of both sides, and vector kernels keep the order of both sides)
+    const auto check_partition = []<typename T>(std::vector<T> values, const T pivot) {
+        std::vector<T> expected(values);
+        std::stable_partition(expected.begin(), expected.end(), [pivot](const T v) { return v < pivot; });
+        std::vector<T> scratch(values.size());
+        const auto partition = IsolationForest::Implementation::partition(std::span<T>(values), pivot, std::span<T>(scratch));
+        assert(partition.mid == static_cast<std::size_t>(std::count_if(expected.begin(), expected.end(), [pivot](const T v) { return v < pivot; })));
+        const auto same = [](const T a, const T b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+        if (IsolationForest::Implementation::Simd::isa() == Isa::scalar || values.size() < 64) {
+            const auto ordered = [](const T a, const T b) { return !std::isnan(a) && (std::isnan(b) || a < b); };
+            for (auto* side : { &values, &expected }) {
+                std::sort(side->begin(), side->begin() + static_cast<std::ptrdiff_t>(partition.mid), ordered);
+                std::sort(side->begin() + static_cast<std::ptrdiff_t>(partition.mid), side->end(), ordered);
+            }
+        }
+        assert(std::equal(values.begin(), values.end(), expected.begin(), same));
+        // (extremes skip NaN, as folding with std::min/std::max does)
+        const auto lowest = [](const auto first, const auto last) {
+            return std::accumulate(first, last, std::numeric_limits<T>::infinity(), [](const T a, const T b) { return std::min(a, b); });
+        };
+        const auto highest = [](const auto first, const auto last) {
+            return std::accumulate(first, last, -std::numeric_limits<T>::infinity(), [](const T a, const T b) { return std::max(a, b); });
+        };
+        if (partition.mid > 0) {
+            assert(partition.left_min == lowest(values.begin(), values.begin() + partition.mid));
+            assert(partition.left_max == highest(values.begin(), values.begin() + partition.mid));
+        }
+        if (partition.mid < values.size()) {
+            assert(partition.right_min == lowest(values.begin() + partition.mid, values.end()));
+            assert(partition.right_max == highest(values.begin() + partition.mid, values.end()));
+        }
+    };
+    for (const Isa isa : { Isa::scalar, Isa::avx2, Isa::avx512 }) {
+        if (IsolationForest::Implementation::Simd::select(isa) != isa) {
+            continue;
+        }
+        for (const std::size_t size : { 0, 1, 7, 33, 1000 }) {
+            std::vector<double> doubles(size);
+            std::vector<float> floats(size);
+            for (std::size_t i{}; i < size; ++i) {
+                doubles[i] = static_cast<double>((i * 7919) % 1000);
+                floats[i] = static_cast<float>(doubles[i]);
+            }
+            check_partition(doubles, 500.5);
+            check_partition(floats, 500.5f);
+            check_partition(doubles, -1.0);
+            for (std::size_t i{}; i < size; i += 3) {
+                doubles[i] = std::numeric_limits<double>::quiet_NaN();
+                floats[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+            check_partition(doubles, 500.5);
+            check_partition(floats, 500.5f);
+        }
+        IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> isa_tree{ 64, 7 };
+        isa_tree.build(wide.begin(), wide.end());
+        assert(isa_tree.nodes().size() == eager_tree.nodes().size());
+        IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> nan_tree{ 64, 7 };
+        nan_tree.build(wide_with_nan.begin(), wide_with_nan.end());
+        assert(nan_tree.nodes().size() == scalar_nan_tree.nodes().size());
+        for (std::size_t i{}; i < nan_tree.nodes().size(); ++i) {
+            assert(nan_tree.nodes()[i].split_value == scalar_nan_tree.nodes()[i].split_value);
+            assert(nan_tree.nodes()[i].left == scalar_nan_tree.nodes()[i].left);
+        }
+        for (const double val : { -5.0, 0.0, 17.0, 17.5, 2048.0, 4095.0, 5000.0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() }) {
+            assert(wide_double_forest.score(val) == deep_forest.score(val, wide.size()));
+            assert(wide_float_forest.score(static_cast<float>(val)) == float_forest.score(static_cast<float>(val), wide.size()));
+        }
+        for (const double val : wide) {
+            assert(wide_double_forest.score(val + 0.5) == deep_forest.score(val + 0.5, wide.size()));
+        }
+    }
+    IsolationForest::Implementation::Simd::select(detected_isa);
+
+    // early exit threshold decision agrees with the score
+    IsolationForest::Forest<double> wide_forest{ 100, 16, 5 };
+    wide_forest.build(wide.begin(), wide.end());
+    std::size_t confident_agreements{};
+    for (std::size_t i{}; i < 8192; i += 3) {
+        const double val{ static_cast<double>(i) - 2048.0 };
+        for (const double threshold : { 0.4, 0.5, 0.6, 0.7 }) {
+            const bool expected{ wide_forest.score(val, wide.size()) >= threshold };
+            assert(wide_forest.is_outlier(val, threshold, wide.size()) == expected);
+            confident_agreements += (wide_forest.is_outlier(val, threshold, wide.size(), 0.999) == expected);
+        }
+    }
+    std::cout << "is_outlier with 0.999 confidence agreed on " << confident_agreements << " of " << (8192 + 2) / 3 * 4 << " decisions\n";
+
+    // threshold calibrated while building matches the scores of the training data
+    IsolationForest::Forest<double> calibrated_forest{ 50, 16, 9 };
+    calibrated_forest.build(wide.begin(), wide.end(), 0.01);
+    std::vector<double> wide_scores;
+    for (const double val : wide) {
+        wide_scores.push_back(calibrated_forest.score(val, wide.size()));
+    }
+    std::sort(wide_scores.begin(), wide_scores.end(), std::greater<double>{});
+    assert(calibrated_forest.threshold() == wide_scores[40]);
+    assert(std::count_if(wide.begin(), wide.end(), [&](const double val) { return calibrated_forest.is_outlier(val); }) >= 41);
+    // (contamination outside [0, 1] is rejected without touching the forest, and a plain rebuild clears the threshold)
+    IsolationForest::Forest<double> recalibrated_forest{ calibrated_forest };
+    for (const double contamination : { -0.1, 1.5, std::numeric_limits<double>::quiet_NaN() }) {
+        bool rejected{ false };
+        try {
+            recalibrated_forest.build(data.begin(), data.end(), contamination);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected && recalibrated_forest.threshold() == calibrated_forest.threshold());
+    }
+    recalibrated_forest.build(data.begin(), data.end());
+    assert(recalibrated_forest.threshold() == std::numeric_limits<double>::infinity() && !recalibrated_forest.is_outlier(10.4));
+
+    // parallel top-k matches the k highest scores of the whole collection
+    const auto strongest = calibrated_forest.top_k(wide.begin(), wide.end(), 41, wide.size(), pool);
+    assert(strongest.size() == 41);
+    for (std::size_t i{}; i < strongest.size(); ++i) {
+        assert(strongest[i].score == wide_scores[i]);
+        assert(strongest[i].score == calibrated_forest.score(wide[strongest[i].index], wide.size()));
+    }
+    assert(parallel_forest.top_k(data.begin(), data.end(), 1, data.size(), pool)[0].index == static_cast<std::size_t>(max_element_index));
+    // (parts of a collection which is not a multiple of the batch size, and k beyond the collection size)
+    const auto everything = calibrated_forest.top_k(wide.begin(), wide.begin() + 3001, 3010, wide.size(), pool);
+    assert(everything.size() == 3001);
+    for (std::size_t i{}; i < everything.size(); ++i) {
+        assert(everything[i].score == calibrated_forest.score(wide[everything[i].index], wide.size()));
+        assert(i == 0 || everything[i - 1].score > everything[i].score || (everything[i - 1].score == everything[i].score && everything[i - 1].index < everything[i].index));
+    }
+
+    // registry of per series forests scores like the forests it holds, also while series are retrained (and on the pool retraining them)
+    IsolationForest::Registry<double> registry;
+    std::vector<IsolationForest::Forest<double>> series;
+    for (std::uint64_t id{}; id < 8; ++id) {
+        series.emplace_back(10, 100, id);
+        series.back().build(data.begin(), data.end());
+        registry.insert(id, series.back(), data.size());
+    }
+    std::vector<std::pair<std::uint64_t, double>> queries;
+    for (const double val : data) {
+        for (std::uint64_t id{}; id < 8; ++id) {
+            queries.emplace_back(7 - id, val);
+        }
+    }
+    std::vector<double> registry_scores(queries.size());
+    registry.score(queries.begin(), queries.end(), registry_scores.begin(), pool);
+    for (std::size_t i{}; i < queries.size(); ++i) {
+        assert(registry_scores[i] == series[queries[i].first].score(queries[i].second, data.size()));
+    }
+    IsolationForest::Implementation::ThreadPool::TaskGroup retraining_group;
+    for (std::uint64_t id{}; id < 8; id += 2) {
+        registry.retrain(id, data, 10, 100, id + 100, pool, retraining_group);
+    }
+    registry.score(queries.begin(), queries.end(), registry_scores.begin(), pool);
+    {
+        // the only worker is busy, so the scoring thread itself executes the queued retrain while it waits
+        IsolationForest::Implementation::ThreadPool single{ 1 };
+        IsolationForest::Implementation::ThreadPool::TaskGroup single_group;
+        std::atomic<bool> started{ false };
+        std::atomic<bool> release{ false };
+        single.submit(single_group, [&started, &release]() {
+            started.store(true);
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        registry.retrain(6, data, 10, 100, 106, single, single_group);
+        registry.score(queries.begin(), queries.end(), registry_scores.begin(), single);
+        release.store(true);
+        single.wait(single_group);
+    }
+    for (std::size_t i{}; i < queries.size(); ++i) {
+        if (queries[i].first % 2 == 1) {
+            assert(registry_scores[i] == series[queries[i].first].score(queries[i].second, data.size()));
+        }
+    }
+    pool.wait(retraining_group);
+    assert(registry.erase(3) && !registry.contains(3) && registry.size() == 7);
+    std::size_t unregistered{};
+    for (const auto& score_unregistered : std::initializer_list<std::function<void()>>{
+             [&]() { registry.score(3, 1.0); },
+             [&]() { registry.score(queries.begin(), queries.end(), registry_scores.begin()); },
+             [&]() { registry.score(queries.begin(), queries.end(), registry_scores.begin(), pool); } }) {
+        try {
+            score_unregistered();
+        } catch (const std::out_of_range&) {
+            ++unregistered;
+        }
+    }
+    assert(unregistered == 3);
+    for (std::size_t i{}; i < 6; ++i) {
+        registry.insert(1, series[1], data.size());
+    }
+    IsolationForest::Forest<double> retrained_series{ 10, 100, 104 };
+    retrained_series.build(data.begin(), data.end());
+    for (const double val : data) {
+        assert(registry.score(4, val) == retrained_series.score(val, data.size()));
+        assert(registry.score(5, val) == series[5].score(val, data.size()));
+        assert(registry.score(1, val) == series[1].score(val, data.size()));
+    }
+
+    // fused ensemble scores every forest like the forest itself
+    IsolationForest::Ensemble<double> ensemble;
+    ensemble.add(forest, data.size());
+    ensemble.add(calibrated_forest, wide.size());
+    ensemble.add(shallow_forest, wide.size());
+    for (const double val : data) {
+        const std::vector<double> scores{ ensemble.score(val) };
+        assert(scores.size() == 3);
+        assert(scores[0] == forest.score(val, data.size()));
+        assert(scores[1] == calibrated_forest.score(val, wide.size()));
+        assert(scores[2] == shallow_forest.score(val, wide.size()));
+    }
+
+    // growing a forest matches building a larger forest
+    IsolationForest::Forest<double> grown_forest{ 15, 8, 42 };
+    grown_forest.build(data.begin(), data.end());
+    IsolationForest::Forest<double> growing_forest{ 10, 8, 42 };
+    growing_forest.build(data.begin(), data.end());
+    growing_forest.grow(data.begin(), data.end(), 5);
+    for (const double val : data) {
+        assert(growing_forest.score(val, data.size()) == grown_forest.score(val, data.size()));
+    }
+    growing_forest.drop(0, 5);
+    assert(growing_forest.forest().size() == 10);
+    for (std::size_t i{}; i < 10; ++i) {
+        assert(growing_forest.forest()[i].nodes().size() == grown_forest.forest()[i + 5].nodes().size());
+    }
+
+    // shards of different data sizes merge into the forest grown directly from both collections, and every
+    // scoring path normalizes each tree by the data size it was trained on
+    IsolationForest::Forest<double> merged_forest{ 10, 8, 42 };
+    merged_forest.build(data.begin(), data.end(), 0.2);
+    std::vector<double> shard_data;
+    for (std::size_t i{}; i < 200; ++i) {
+        shard_data.push_back(data[i % data.size()] * (1.0 + 0.001 * static_cast<double>(i / data.size())));
+    }
+    IsolationForest::Forest<double> shard_forest{ 20, 8, 42 };
+    shard_forest.build(shard_data.begin(), shard_data.end());
+    shard_forest.drop(0, 10);
+    IsolationForest::Forest<double> direct_forest{ 0, 8, 42 };
+    direct_forest.grow(data.begin(), data.end(), 10);
+    direct_forest.grow(shard_data.begin(), shard_data.end(), 10);
+    std::vector<double> merge_values(data);
+    merge_values.insert(merge_values.end(), shard_data.begin(), shard_data.end());
+    std::vector<double> expected_merged;
+    for (const double val : merge_values) {
+        expected_merged.push_back(std::exp2((std::log2(merged_forest.score(val, data.size())) + std::log2(shard_forest.score(val, shard_data.size()))) / 2.0));
+    }
+    merged_forest.merge(shard_forest);
+    assert(merged_forest.forest().size() == 20);
+    IsolationForest::Ensemble<double> merged_ensemble;
+    merged_ensemble.add(merged_forest);
+    IsolationForest::Registry<double> merged_registry;
+    merged_registry.insert(9, merged_forest);
+    std::vector<double> merged_scores(merge_values.size());
+    std::vector<double> pooled_merged_scores(merge_values.size());
+    merged_forest.score(merge_values.begin(), merge_values.end(), merged_scores.begin());
+    merged_forest.score(merge_values.begin(), merge_values.end(), pooled_merged_scores.begin(), pool);
+    std::size_t merged_outliers{};
+    for (std::size_t i{}; i < merge_values.size(); ++i) {
+        const double val{ merge_values[i] };
+        assert(merged_forest.score(val) == direct_forest.score(val));
+        assert(std::abs(merged_forest.score(val) - expected_merged[i]) < 1e-12);
+        assert(merged_scores[i] == merged_forest.score(val) && pooled_merged_scores[i] == merged_forest.score(val));
+        assert(merged_forest.is_outlier(val) == (merged_forest.score(val) >= merged_forest.threshold()));
+        assert(merged_ensemble.score(val)[0] == merged_forest.score(val));
+        assert(merged_registry.score(9, val) == merged_forest.score(val));
+        merged_outliers += merged_forest.is_outlier(val);
+    }
+    assert(merged_outliers > 0 && merged_outliers < merge_values.size());
+    std::vector<std::size_t> merged_order(merge_values.size());
+    std::iota(merged_order.begin(), merged_order.end(), std::size_t{});
+    std::stable_sort(merged_order.begin(), merged_order.end(), [&](const std::size_t a, const std::size_t b) { return merged_scores[a] > merged_scores[b]; });
+    const auto merged_strongest = merged_forest.top_k(merge_values.begin(), merge_values.end(), 10, pool);
+    assert(merged_strongest.size() == 10);
+    for (std::size_t r{}; r < 10; ++r) {
+        assert(merged_strongest[r].index == merged_order[r] && merged_strongest[r].score == merged_scores[merged_order[r]]);
+    }
+    const double merged_score{ merged_forest.score(data[0]) };
+    merged_forest.merge(merged_forest);
+    assert(merged_forest.forest().size() == 40 && std::abs(merged_forest.score(data[0]) - merged_score) < 1e-12);
+
+    // adaptive build stops once the held out ranking is stable, and equals a forest of the chosen size
+    IsolationForest::Forest<double> adaptive_forest{ 0, 16, 11 };
+    const std::size_t adaptive_trees{ adaptive_forest.build_adaptive(wide.begin(), wide.end(), wide.begin(), wide.begin() + 512, 10, 0.01, 500) };
+    assert(adaptive_trees >= 20 && adaptive_trees < 500 && adaptive_trees % 10 == 0);
+    IsolationForest::Forest<double> fixed_forest{ adaptive_trees, 16, 11 };
+    fixed_forest.build(wide.begin(), wide.end());
+    for (std::size_t i{}; i < wide.size(); i += 7) {
+        assert(adaptive_forest.score(wide[i], wide.size()) == fixed_forest.score(wide[i], wide.size()));
+    }
+    std::cout << "adaptive build chose " << adaptive_trees << " trees\n";
+
+    // pruned forest reports its largest score deviation from the full forest on the validation sample
+    IsolationForest::Forest<double> pruned_forest{ fixed_forest };
+    const double deviation{ pruned_forest.prune(wide.begin(), wide.begin() + 512, 20, wide.size()) };
+    assert(pruned_forest.forest().size() == 20);
+    double max_deviation{};
+    for (std::size_t i{}; i < 512; ++i) {
+        max_deviation = std::max(max_deviation, std::abs(pruned_forest.score(wide[i], wide.size()) - fixed_forest.score(wide[i], wide.size())));
+    }
+    assert(deviation == max_deviation && deviation < 0.05);
+    std::cout << "pruning " << fixed_forest.forest().size() << " trees to 20 deviates by " << deviation << '\n';
+
+    // forest grown online by insertions isolates the outlier and is normalized by its decayed mass, built trees keep growing on insertion
+    IsolationForest::Forest<double> online_forest{ 100, 16, 21 };
+    for (std::size_t r{}; r < 20; ++r) {
+        for (const double val : data) {
+            online_forest.insert(val, 4.0, 0.999);
+        }
+    }
+    std::vector<double> online_score;
+    for (const double val : data) {
+        online_score.push_back(online_forest.score(val, data.size()));
+    }
+    assert(data[std::distance(online_score.begin(), std::max_element(online_score.begin(), online_score.end()))] == 10.4);
+    const double online_mass{ (1.0 - std::pow(0.999, static_cast<double>(20 * data.size()))) / (1.0 - 0.999) };
+    for (const double val : data) {
+        assert(std::abs(online_forest.score(val) - online_forest.score(val, static_cast<std::int64_t>(std::round(online_mass)))) < 1e-12);
+        assert(online_forest.is_outlier(val) == online_forest.is_outlier(val, online_forest.threshold(), static_cast<std::int64_t>(std::round(online_mass))));
+    }
+    IsolationForest::Implementation::ITree<IsolationForest::Implementation::INode<double>> online_tree{ 64, 7 };
+    online_tree.build(wide.begin(), wide.begin() + 64);
+    const std::size_t built_nodes{ online_tree.node_count() };
+    for (const double val : wide) {
+        online_tree.insert(val, 16.0);
+    }
+    assert(online_tree.node_count() > built_nodes && online_tree.max_path_length() > eager_tree.min_path_length());
+    for (std::size_t i{}; i < online_tree.nodes().size(); ++i) {
+        const auto& node = online_tree.nodes()[i];
+        assert(node.left < 0 || (node.left < online_tree.root_id() && node.right < online_tree.root_id()));
+    }
+    // (path length bounds are kept up to date split by split)
+    for (const auto* grown : std::initializer_list<const decltype(online_tree)*>{ &online_tree, &online_forest.forest()[0] }) {
+        const auto depths = IsolationForest::Implementation::node_depths(grown->nodes());
+        double shortest{ std::numeric_limits<double>::max() };
+        double longest{ std::numeric_limits<double>::lowest() };
+        for (std::size_t i{}; i < depths.size(); ++i) {
+            if (grown->nodes()[i].left < 0) {
+                shortest = std::min(shortest, static_cast<double>(depths[i] - 1));
+                longest = std::max(longest, static_cast<double>(depths[i] - 1));
+            }
+        }
+        assert(grown->min_path_length() == shortest && grown->max_path_length() == longest);
+    }
+    // (decay outside (0, 1] is rejected before anything changes)
+    const double online_before{ online_forest.score(data[0], data.size()) };
+    for (const double decay : { 0.0, -0.5, 1.5, std::numeric_limits<double>::quiet_NaN() }) {
+        bool rejected{ false };
+        try {
+            online_forest.insert(1.0, 4.0, decay);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+    assert(online_forest.score(data[0], data.size()) == online_before);
+
+    // random cut forest over a sliding window isolates the outlier, and releases all nodes once the window is empty
+    IsolationForest::RandomCutForest<double> cut_forest{ 50, 3 };
+    std::deque<std::size_t> window;
+    for (std::size_t r{}; r < 3; ++r) {
+        for (const double val : data) {
+            window.push_back(cut_forest.insert(val));
+            if (window.size() > data.size()) {
+                cut_forest.erase(window.front());
+                window.pop_front();
+            }
+        }
+    }
+    assert(cut_forest.size() == data.size());
+    std::vector<double> displacement;
+    for (const std::size_t id : window) {
+        displacement.push_back(cut_forest.codisp(id));
+    }
+    assert(data[std::distance(displacement.begin(), std::max_element(displacement.begin(), displacement.end()))] == 10.4);
+    assert(cut_forest.score(10.4) == cut_forest.score(10.4) && cut_forest.score(10.4) > cut_forest.score(1.0));
+    while (!window.empty()) {
+        cut_forest.erase(window.front());
+        window.pop_front();
+    }
+    assert(cut_forest.size() == 0 && cut_forest.forest()[0].node_count() == 0);
+
+    // half-space trees score sparse regions higher, also after windows were replaced by concurrent insertions
+    IsolationForest::HalfSpaceForest<double> half_space_forest{ 25, 10, 256, 5 };
+    half_space_forest.build(wide.begin(), wide.begin() + 256);
+    assert(half_space_forest.score(-5000.0) > half_space_forest.score(2048.0));
+    std::vector<std::thread> inserters;
+    for (std::size_t t{}; t < 4; ++t) {
+        inserters.emplace_back([&half_space_forest, t]() {
+            for (std::size_t i{}; i < 256; ++i) {
+                half_space_forest.insert(1000.0 + static_cast<double>((i * 4 + t) % 64));
+            }
+        });
+    }
+    for (auto& thread : inserters) {
+        thread.join();
+    }
+    assert(half_space_forest.score(1030.0) < half_space_forest.score(3000.0));
+    // (NaN is not counted and scores 1, also when the reference window holds it)
+    IsolationForest::HalfSpaceForest<double> nan_half_space_forest{ 25, 10, 256, 5 };
+    nan_half_space_forest.build(wide_with_nan.begin(), wide_with_nan.begin() + 256);
+    nan_half_space_forest.insert(std::numeric_limits<double>::quiet_NaN());
+    assert(nan_half_space_forest.score(std::numeric_limits<double>::quiet_NaN()) == 1.0);
+    assert(nan_half_space_forest.score(-5000.0) > nan_half_space_forest.score(2048.0));
+
+    // scoring is noexcept and allocation free
+    static_assert(noexcept(forest.score(1.0, data.size())) && noexcept(forest.is_outlier(1.0, 0.6, data.size())));
+    static_assert(!IsolationForest::LazyForest<double>::nothrow_score);
+    double score_sum{};
+    const std::size_t allocations_before{ allocations.load() };
+    for (const double val : wide) {
+        score_sum += calibrated_forest.score(val, wide.size()) + calibrated_forest.score(val);
+        score_sum += calibrated_forest.is_outlier(val, 0.6, wide.size(), 0.99) ? 1.0 : 0.0;
+        score_sum += quick_scorer.score(val, wide.size());
+    }
+    assert(allocations.load() == allocations_before && score_sum > 0.0);
+
 	return 1;
 }
@@ -0,0 +1,208 @@
+// generated by IsolationForest::Implementation::to_source, do not edit
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+namespace GeneratedForest {
+	struct Node {
+		double split_value;
+		std::int64_t left;
+		std::int64_t right;
+	};
+
+	inline constexpr Node nodes[] = {
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.cca72597d40a3p-1, 1, 2 },
+		{ 0x1.5daa64db25678p-3, 0, 3 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.f0526db1bf4fep-1, 5, 6 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.3433e4ae87d17p+0, 8, 9 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.559f9f49d7f03p+0, 11, 12 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.74170a54ff429p+0, 14, 15 },
+		{ 0x1.5e5a98999aeacp+0, 13, 16 },
+		{ 0x1.48771aac52527p+0, 10, 17 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.dd07df8ff41a4p+0, 20, 21 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.df87983c48d84p+0, 22, 23 },
+		{ 0x1.d3eeafe5f3859p+0, 19, 24 },
+		{ 0x1.7d74431cba1c2p+0, 18, 25 },
+		{ 0x1.fb5809dc975a3p-1, 7, 26 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.fd9f13b48ca7fp+0, 28, 29 },
+		{ 0x1.e678c0791e1ebp+0, 27, 30 },
+		{ 0x1.cd8f5e7407d84p-1, 4, 31 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.0722f696893a6p+3, 32, 33 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.cd3fcfc984835p-1, 36, 37 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.f0fdf16257cedp-1, 39, 40 },
+		{ 0x1.d083005a297p-1, 38, 41 },
+		{ 0x1.a2eeedd5fdc1ap-2, 35, 42 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.4b1ea9b1eca2p+0, 45, 46 },
+		{ 0x1.3b09772190d08p+0, 44, 47 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.6768c4d20564dp+0, 49, 50 },
+		{ 0x1.54f1bb8eff00bp+0, 48, 51 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.dcf7831c093c3p+0, 55, 56 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.e05666a2eb158p+0, 57, 58 },
+		{ 0x1.ce1fd34b153b5p+0, 54, 59 },
+		{ 0x1.8eb68e5140b27p+0, 53, 60 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.fe89102e11fcbp+0, 62, 63 },
+		{ 0x1.f271b22cd5484p+0, 61, 64 },
+		{ 0x1.7a3fc5ac44399p+0, 52, 65 },
+		{ 0x1.2a06fefcfcc4cp+0, 43, 66 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.0cc449d4e707fp+1, 67, 68 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.ccd1e59753e3ep-1, 71, 72 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.d1806abf902f5p-1, 73, 74 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.f21333dbbb01ap-1, 75, 76 },
+		{ 0x1.275a70ae09444p-1, 70, 77 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.37ee8c052ac1p+0, 79, 80 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.4b0905175a97fp+0, 81, 82 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.65166f28a06b5p+0, 84, 85 },
+		{ 0x1.55fcc6658b6d1p+0, 83, 86 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.74f5f032c8fc3p+0, 87, 88 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.d8211b47c97ep+0, 90, 91 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.e164a73058c55p+0, 93, 94 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.f3a6fe07e10acp+0, 95, 96 },
+		{ 0x1.dd880afc4c8e8p+0, 92, 97 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.fc3e5390ca81ap+0, 98, 99 },
+		{ 0x1.b576ce5c780b4p+0, 89, 100 },
+		{ 0x1.08e7ed8d3e3c4p+0, 78, 101 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.f6ef8b7fc0403p+2, 102, 103 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.cca490774f0f5p-1, 106, 107 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.fa3f9149cb87fp-1, 109, 110 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.3a9428fa9ff36p+0, 112, 113 },
+		{ 0x1.07d6161d3fef8p+0, 111, 114 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.44317d8675492p+0, 115, 116 },
+		{ 0x1.df816480c2addp-1, 108, 117 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.77e705ddd940ep+0, 120, 121 },
+		{ 0x1.71f39c411b32cp+0, 119, 122 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.dcfb6a12761d3p+0, 125, 126 },
+		{ 0x1.d109a7a071f4bp+0, 124, 127 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.e2d2521a75be1p+0, 128, 129 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.fb2fa3ac84ac9p+0, 131, 132 },
+		{ 0x1.eb5c8bf1ed68dp+0, 130, 133 },
+		{ 0x1.b1920352d0387p+0, 123, 134 },
+		{ 0x1.557842bcb2e8p+0, 118, 135 },
+		{ 0x1.9b3ae87db61d8p-5, 105, 136 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.aa6c475f81046p+2, 137, 138 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.ccc55021639aap-1, 141, 142 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.142f7b2f92d7ep+0, 144, 145 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.4bbf5ff2d2557p+0, 147, 148 },
+		{ 0x1.3f58edd52fff7p+0, 146, 149 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.68faeba2f95c3p+0, 151, 152 },
+		{ 0x1.515853c66f506p+0, 150, 153 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.77cea03f85ce1p+0, 154, 155 },
+		{ 0x1.dedff8454b59cp-1, 143, 156 },
+		{ 0x1.3f46bcdfa6f39p-1, 140, 157 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.dd64ded2cd215p+0, 160, 161 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.de08fbf8ab33ap+0, 162, 163 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.e933cae563836p+0, 164, 165 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.ff974537f5abfp+0, 166, 167 },
+		{ 0x1.da0b3cfd2240ep+0, 159, 168 },
+		{ 0x1.c132fc9188515p+0, 158, 169 },
+		{ 0x0p+0, -1, -1 },
+		{ 0x1.4a5fb90d9f523p+1, 170, 171 },
+	};
+
+	inline constexpr std::int64_t roots[] = { 34, 69, 104, 139, 172, };
+
+	inline constexpr double normalization{ 0x1.492bfab86f99cp+2 };
+
+	inline double score(const double value) noexcept {
+		double avg_path_len{};
+		for (const std::int64_t root : roots) {
+			std::int64_t index{ root };
+			std::int64_t depth{};
+			while (nodes[index].left >= 0) {
+				index = (value < nodes[index].split_value) ? nodes[index].left : nodes[index].right;
+				++depth;
+			}
+			avg_path_len += static_cast<double>(depth - 1);
+		}
+		avg_path_len /= static_cast<double>(5);
+
+		return static_cast<double>(std::pow(static_cast<double>(2.0), -avg_path_len / normalization));
+	}
+};